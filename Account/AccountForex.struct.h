@@ -28,7 +28,7 @@
 #ifndef __MQL__
 // Allows the preprocessor to include a header file when it is needed.
 #pragma once
-#include "Serializer.enum.h"
+#include "../Serializer.enum.h"
 #endif
 
 // Forward class declaration.
@@ -0,0 +1,152 @@
+//+------------------------------------------------------------------+
+//|                                                EA31337 framework |
+//|                                 Copyright 2016-2022, EA31337 Ltd |
+//|                                       https://github.com/EA31337 |
+//+------------------------------------------------------------------+
+
+/*
+ * This file is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// Prevents processing this includes file for the second time.
+#ifndef BUFFER_BAR_VALUES_H
+#define BUFFER_BAR_VALUES_H
+
+// Includes.
+#include "../Refs.mqh"
+
+/**
+ * Fixed number of slots storing values of all modes of a bar, keyed by bar's time.
+ *
+ * Bar's slot is its time in minutes modulo capacity, so with a prime capacity
+ * bars of any timeframe are spread evenly. Slot is overwritten by a colliding
+ * bar, so lookup is always a direct array access.
+ */
+template <typename T>
+class BufferBarValues : public Dynamic {
+ protected:
+  ARRAY(long, times);  // Bar's time per slot, 0 for empty slot.
+  ARRAY(T, values);    // Values of all modes per slot.
+  T empty_value;       // Value of modes which weren't stored yet.
+  int capacity;
+  int num_modes;
+  unsigned long num_hits, num_misses;
+
+  /**
+   * Returns slot for a given bar's time.
+   */
+  int GetSlot(long _time) { return (int)((_time / 60) % capacity); }
+
+ public:
+  /* Special methods */
+
+  /**
+   * Class constructor.
+   *
+   * @param _capacity
+   *   Number of slots. Should be a prime number.
+   */
+  BufferBarValues(int _num_modes = 1, int _capacity = 4099)
+      : capacity(0), num_modes(0), num_hits(0), num_misses(0) {
+    empty_value = (T)0;
+    Resize(_num_modes, _capacity);
+  }
+
+  /* Getters */
+
+  /**
+   * Returns number of slots.
+   */
+  int GetCapacity() { return capacity; }
+
+  /**
+   * Returns number of values stored per bar.
+   */
+  int GetNumModes() { return num_modes; }
+
+  /**
+   * Returns number of lookups which found the bar.
+   */
+  unsigned long GetHits() { return num_hits; }
+
+  /**
+   * Returns number of lookups which didn't find the bar.
+   */
+  unsigned long GetMisses() { return num_misses; }
+
+  /**
+   * Checks whether values of a given bar are stored.
+   */
+  bool Has(long _time) { return _time > 0 && times[GetSlot(_time)] == _time; }
+
+  /**
+   * Gets stored value of a given bar and mode.
+   *
+   * @return
+   *   Returns true if bar was found.
+   */
+  bool TryGet(long _time, int _mode, T &_value) {
+    if (!Has(_time) || _mode < 0 || _mode >= num_modes) {
+      ++num_misses;
+      return false;
+    }
+    ++num_hits;
+    _value = values[GetSlot(_time) * num_modes + _mode];
+    return true;
+  }
+
+  /* Setters */
+
+  /**
+   * Sets value of modes which weren't stored yet for a newly stored bar.
+   */
+  void SetEmptyValue(T _value) { empty_value = _value; }
+
+  /**
+   * Stores value of a given bar and mode. Values of other modes of a newly stored bar are set to the empty value.
+   */
+  void Set(long _time, int _mode, T _value) {
+    int _slot = GetSlot(_time);
+    if (times[_slot] != _time) {
+      times[_slot] = _time;
+      for (int i = 0; i < num_modes; ++i) {
+        values[_slot * num_modes + i] = empty_value;
+      }
+    }
+    values[_slot * num_modes + _mode] = _value;
+  }
+
+  /**
+   * Changes number of modes and slots. Stored values are dropped.
+   */
+  void Resize(int _num_modes, int _capacity) {
+    num_modes = _num_modes > 0 ? _num_modes : 1;
+    capacity = _capacity > 0 ? _capacity : 1;
+    ArrayResize(times, capacity);
+    ArrayResize(values, capacity * num_modes);
+    Clear();
+  }
+
+  /**
+   * Removes all stored values.
+   */
+  void Clear() {
+    for (int i = 0; i < capacity; ++i) {
+      times[i] = 0;
+    }
+  }
+};
+
+#endif  // BUFFER_BAR_VALUES_H
@@ -0,0 +1,211 @@
+//+------------------------------------------------------------------+
+//|                                                EA31337 framework |
+//|                                 Copyright 2016-2022, EA31337 Ltd |
+//|                                       https://github.com/EA31337 |
+//+------------------------------------------------------------------+
+
+/*
+ * This file is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// Prevents processing this includes file for the second time.
+#ifndef BUFFER_CANDLE_RING_H
+#define BUFFER_CANDLE_RING_H
+
+// Includes.
+#include "../Candle.struct.h"
+#include "../Refs.mqh"
+
+/**
+ * Fixed-size ring of candles ordered by their open times.
+ *
+ * Shift 0 is the newest candle. Shift to candle is a direct array access and
+ * time to shift is a binary search over candles' open times.
+ */
+template <typename TV>
+class BufferCandleRing : public Dynamic {
+ protected:
+  ARRAY(CandleOCTOHLC<TV>, candles);
+  ARRAY(long, times);  // Candles' open times (start of the candle's period).
+  int capacity;
+  int head;  // Position of the newest candle.
+  int count;
+
+  /**
+   * Returns position in the arrays for a given shift.
+   */
+  int ShiftToPos(int _shift) { return (head - _shift + capacity) % capacity; }
+
+ public:
+  /* Constructors */
+
+  /**
+   * Constructor.
+   */
+  BufferCandleRing(int _capacity = 10000) : capacity(0), head(-1), count(0) { Resize(_capacity); }
+
+  /* Getters */
+
+  /**
+   * Returns maximum number of stored candles.
+   */
+  int GetCapacity() { return capacity; }
+
+  /**
+   * Returns number of stored candles.
+   */
+  int Size() { return count; }
+
+  /**
+   * Returns candle at a given shift. Returns invalid candle if there is no candle at given shift.
+   */
+  CandleOCTOHLC<TV> GetByShift(int _shift) {
+    if (_shift < 0 || _shift >= count) {
+      CandleOCTOHLC<TV> _invalid;
+      return _invalid;
+    }
+    return candles[ShiftToPos(_shift)];
+  }
+
+  /**
+   * Returns candle's open time at a given shift. Returns -1 if there is no candle at given shift.
+   */
+  long GetTimeByShift(int _shift) { return _shift >= 0 && _shift < count ? times[ShiftToPos(_shift)] : -1; }
+
+  /**
+   * Returns open time of the newest candle or -1 if ring is empty.
+   */
+  long GetNewestTime() { return count > 0 ? times[head] : -1; }
+
+  /**
+   * Returns open time of the oldest candle or -1 if ring is empty.
+   */
+  long GetOldestTime() { return count > 0 ? times[ShiftToPos(count - 1)] : -1; }
+
+  /**
+   * Returns shift of the candle with given open time.
+   *
+   * @param _exact
+   *   When false, returns shift of the newest candle opened at or before given time.
+   *
+   * @return
+   *   Returns shift or -1 if candle couldn't be found.
+   */
+  int GetShiftByTime(long _time, bool _exact = true) {
+    if (count == 0 || _time < GetOldestTime()) {
+      return -1;
+    }
+    // Binary search over shifts. Times are descending with the shift.
+    int _lo = 0, _hi = count - 1;
+    while (_lo < _hi) {
+      int _mid = (_lo + _hi) / 2;
+      if (times[ShiftToPos(_mid)] > _time) {
+        _lo = _mid + 1;
+      } else {
+        _hi = _mid;
+      }
+    }
+    if (_exact && times[ShiftToPos(_lo)] != _time) {
+      return -1;
+    }
+    return _lo;
+  }
+
+  /* Setters */
+
+  /**
+   * Adds candle as the newest one. Overwrites the oldest candle when ring is full.
+   */
+  void Push(long _time, const CandleOCTOHLC<TV>& _candle) {
+    head = (head + 1) % capacity;
+    candles[head] = _candle;
+    times[head] = _time;
+    count = count < capacity ? count + 1 : capacity;
+  }
+
+  /**
+   * Inserts candle keeping candles ordered by their open times. Drops the oldest candle when ring is full.
+   * Candle with the same open time is replaced.
+   *
+   * Candle newer than all stored ones is pushed in O(1), otherwise newer candles are moved by one shift.
+   *
+   * @return
+   *   Returns shift of the inserted candle or -1 if ring is full and candle is older than all stored ones.
+   */
+  int Insert(long _time, const CandleOCTOHLC<TV>& _candle) {
+    if (count == 0 || _time > GetNewestTime()) {
+      Push(_time, _candle);
+      return 0;
+    }
+    int _older = GetShiftByTime(_time, false);
+    if (_older != -1 && times[ShiftToPos(_older)] == _time) {
+      candles[ShiftToPos(_older)] = _candle;
+      return _older;
+    }
+    if (_older == -1 && count == capacity) {
+      return -1;
+    }
+    // Number of candles newer than the inserted one.
+    int _newer = _older != -1 ? _older : count;
+    head = (head + 1) % capacity;
+    count = count < capacity ? count + 1 : capacity;
+    for (int _shift = 0; _shift < _newer; ++_shift) {
+      int _dst = ShiftToPos(_shift), _src = ShiftToPos(_shift + 1);
+      candles[_dst] = candles[_src];
+      times[_dst] = times[_src];
+    }
+    candles[ShiftToPos(_newer)] = _candle;
+    times[ShiftToPos(_newer)] = _time;
+    return _newer;
+  }
+
+  /**
+   * Updates candle at a given shift with the tick's price.
+   */
+  void UpdateByShift(int _shift, long _timestamp, TV _price) {
+    int _pos = ShiftToPos(_shift);
+    if (candles[_pos].open_timestamp == -1) {
+      CandleOCTOHLC<TV> _candle(_price, _price, _price, _price, _timestamp, _timestamp);
+      candles[_pos] = _candle;
+    } else {
+      candles[_pos].Update(_timestamp, _price);
+    }
+  }
+
+  /**
+   * Merges given candle into candle at a given shift.
+   */
+  void MergeByShift(int _shift, const CandleOCTOHLC<TV>& _candle) { candles[ShiftToPos(_shift)].Merge(_candle); }
+
+  /**
+   * Changes capacity of the ring. Stored candles are dropped.
+   */
+  void Resize(int _capacity) {
+    capacity = _capacity > 0 ? _capacity : 1;
+    ArrayResize(candles, capacity);
+    ArrayResize(times, capacity);
+    Clear();
+  }
+
+  /**
+   * Removes all candles.
+   */
+  void Clear() {
+    head = -1;
+    count = 0;
+  }
+};
+
+#endif  // BUFFER_CANDLE_RING_H
@@ -25,46 +25,74 @@
 #define BUFFER_TICK_H
 
 // Includes.
-#include "../BufferStruct.mqh"
 #include "../Chart.enum.h"
 #include "../Storage/IValueStorage.h"
+#include "../Storage/ValueStorage.h"
 #include "../Tick.struct.h"
+#include "BufferCandle.h"
 
+// Forward declarations.
 template <typename TV>
-class BufferTickValueStorage : ValueStorage<TV> {
+class BufferTick;
+
+template <typename TV>
+class BufferTickValueStorage : public ValueStorage<TV> {
   // Poiner to buffer to take tick from.
   BufferTick<TV> *buffer_tick;
 
   // PRICE_ASK or PRICE_BID.
   int applied_price;
 
+  // Whether storage operates in as-series mode.
+  bool is_series;
+
  public:
   /**
    * Constructor.
    */
-  BufferTickValueStorage(BufferTick<TV> *_buffer_tick, int _applied_price)
-      : buffer_tick(_buffer_tick), applied_price(_applied_price) {}
+  BufferTickValueStorage(BufferTick<TV> *_buffer_tick, int _applied_price, bool _is_series = false)
+      : buffer_tick(_buffer_tick), applied_price(_applied_price), is_series(_is_series) {}
 
   /**
    * Fetches value from a given shift. Takes into consideration as-series flag.
    */
   TV Fetch(int _shift) override {
-    Print("BufferTickValueStorage: Fetching " + (applied_price == PRICE_ASK ? "Ask" : "Bid") + " price from shift ",
-          _shift);
-    return 0;
+    int _pos = is_series ? buffer_tick.GetSortedSize() - _shift - 1 : _shift;
+    return buffer_tick.GetSortedPrice(_pos, applied_price);
   }
 
   /**
    * Returns number of values available to fetch (size of the values buffer).
    */
-  int Size() const override { return (int)buffer_tick.Size(); }
+  int Size() const override { return buffer_tick.GetSortedSize(); }
+
+  /**
+   * Checks whether storage operates in as-series mode.
+   */
+  bool IsSeries() const override { return is_series; }
+
+  /**
+   * Sets storage's as-series mode on or off.
+   */
+  bool SetSeries(bool _value) override {
+    is_series = _value;
+    return true;
+  }
 };
 
+#ifndef BUFFER_TICK_MAX_SIZE
+// Maximum number of ticks kept by default, the oldest ones are evicted.
+#define BUFFER_TICK_MAX_SIZE 86400
+#endif
+
 /**
- * Class to store struct data.
+ * Class to store ticks.
+ *
+ * Ticks are kept in a bounded ring ordered by time (from the oldest to the newest one). New ticks are appended in
+ * O(1), late ticks are inserted by shifting only the newer ones. Once the ring is full, the oldest tick is evicted.
  */
 template <typename TV>
-class BufferTick : public BufferStruct<TickAB<TV>> {
+class BufferTick {
  protected:
   // Ask prices ValueStorage proxy.
   BufferTickValueStorage<TV> *_vs_ask;
@@ -72,6 +100,22 @@ class BufferTick : public BufferStruct<TickAB<TV>> {
   // Bid prices ValueStorage proxy.
   BufferTickValueStorage<TV> *_vs_bid;
 
+  // Ring of ticks ordered by time.
+  ARRAY(long, ring_times);
+  ARRAY(TickAB<TV>, ring_ticks);
+  int ring_head;      // Slot of the oldest tick.
+  int ring_count;     // Number of ticks in the ring.
+  int ring_capacity;  // Maximum number of ticks in the ring.
+
+  // Lowest position in the ring changed since the last grouping.
+  int sorted_changed_pos;
+
+  // Reusable buffer of candles made by GroupBySecs().
+  BufferCandle<TV> grouped;
+  unsigned int grouped_spc;
+  int grouped_ap;
+  int grouped_pos;  // Number of ticks in the ring already grouped.
+
  protected:
   /* Protected methods */
 
@@ -83,7 +127,70 @@ class BufferTick : public BufferStruct<TickAB<TV>> {
   void Init() {
     _vs_ask = NULL;
     _vs_bid = NULL;
-    SetOverflowListener(BufferTickOverflowListener, 10);
+    sorted_changed_pos = INT_MAX;
+    grouped_spc = 0;
+    grouped_ap = PRICE_BID;
+    grouped_pos = 0;
+  }
+
+  /**
+   * Returns slot of the tick at given position (0 is the oldest tick).
+   */
+  int GetSlot(int _pos) {
+    int _slot = ring_head + _pos;
+    int _num_slots = ArraySize(ring_times);
+    return _slot < _num_slots ? _slot : _slot - _num_slots;
+  }
+
+  /**
+   * Returns position of the first tick at or after given time.
+   */
+  int LowerBoundSorted(long _time) {
+    int _lo = 0, _hi = ring_count;
+    while (_lo < _hi) {
+      int _mid = (_lo + _hi) / 2;
+      if (ring_times[GetSlot(_mid)] < _time) {
+        _lo = _mid + 1;
+      } else {
+        _hi = _mid;
+      }
+    }
+    return _lo;
+  }
+
+  /**
+   * Makes room for one more tick. Slots after the head are moved to the end of the grown ring.
+   */
+  void Grow() {
+    int _num_slots = ArraySize(ring_times);
+    if (ring_count < _num_slots) {
+      return;
+    }
+    int _new_num_slots = _num_slots > 0 ? _num_slots * 2 : 1024;
+    _new_num_slots = _new_num_slots < ring_capacity ? _new_num_slots : ring_capacity;
+    ArrayResize(ring_times, _new_num_slots);
+    ArrayResize(ring_ticks, _new_num_slots);
+    int _delta = _new_num_slots - _num_slots;
+    if (ring_head > 0) {
+      for (int i = _num_slots - 1; i >= ring_head; --i) {
+        ring_times[i + _delta] = ring_times[i];
+        ring_ticks[i + _delta] = ring_ticks[i];
+      }
+      ring_head += _delta;
+    }
+  }
+
+  /**
+   * Evicts the oldest tick.
+   */
+  void EvictOldest() {
+    ring_head = GetSlot(1);
+    --ring_count;
+    // Positions of the remaining ticks have moved.
+    grouped_pos = grouped_pos > 0 ? grouped_pos - 1 : 0;
+    if (sorted_changed_pos != INT_MAX) {
+      sorted_changed_pos = sorted_changed_pos > 0 ? sorted_changed_pos - 1 : 0;
+    }
   }
 
  public:
@@ -92,7 +199,7 @@ class BufferTick : public BufferStruct<TickAB<TV>> {
   /**
    * Constructor.
    */
-  BufferTick() { Init(); }
+  BufferTick() : ring_head(0), ring_count(0), ring_capacity(BUFFER_TICK_MAX_SIZE) { Init(); }
   BufferTick(BufferTick &_right) {
     THIS_REF = _right;
     Init();
@@ -110,6 +217,109 @@ class BufferTick : public BufferStruct<TickAB<TV>> {
     }
   }
 
+  /* Main methods */
+
+  /**
+   * Adds new tick or replaces the one with the same timestamp.
+   *
+   * @return
+   *   Returns false if the ring is full and the tick is older than all stored ones.
+   */
+  bool Add(TickAB<TV> &_value, long _dt = 0) {
+    _dt = _dt > 0 ? _dt : TimeCurrent();
+    int _pos = ring_count;
+    if (ring_count > 0 && ring_times[GetSlot(ring_count - 1)] >= _dt) {
+      // Late tick.
+      _pos = LowerBoundSorted(_dt);
+      if (ring_times[GetSlot(_pos)] == _dt) {
+        // Tick with the same timestamp is replaced.
+        ring_ticks[GetSlot(_pos)] = _value;
+        sorted_changed_pos = _pos < sorted_changed_pos ? _pos : sorted_changed_pos;
+        return true;
+      }
+    }
+    if (ring_count >= ring_capacity) {
+      if (_pos == 0) {
+        return false;
+      }
+      EvictOldest();
+      --_pos;
+    }
+    Grow();
+    for (int i = ring_count; i > _pos; --i) {
+      ring_times[GetSlot(i)] = ring_times[GetSlot(i - 1)];
+      ring_ticks[GetSlot(i)] = ring_ticks[GetSlot(i - 1)];
+    }
+    ring_times[GetSlot(_pos)] = _dt;
+    ring_ticks[GetSlot(_pos)] = _value;
+    ++ring_count;
+    sorted_changed_pos = _pos < sorted_changed_pos ? _pos : sorted_changed_pos;
+    return true;
+  }
+
+  /**
+   * Clear entries older (or newer) than given timestamp.
+   */
+  void Clear(long _dt = 0, bool _older = true) {
+    if (_dt <= 0) {
+      ring_head = 0;
+      ring_count = 0;
+    } else if (_older) {
+      int _num_removed = LowerBoundSorted(_dt);
+      ring_head = GetSlot(_num_removed);
+      ring_count -= _num_removed;
+    } else {
+      ring_count = LowerBoundSorted(_dt + 1);
+    }
+    grouped.Clear();
+    grouped_pos = 0;
+    sorted_changed_pos = INT_MAX;
+  }
+
+  /* Getters */
+
+  /**
+   * Returns number of ticks.
+   */
+  int Size() { return ring_count; }
+
+  /**
+   * Returns maximum number of ticks kept.
+   */
+  int GetCapacity() { return ring_capacity; }
+
+  /**
+   * Checks whether tick with given timestamp exists.
+   */
+  bool KeyExists(long _time) {
+    int _pos = LowerBoundSorted(_time);
+    return _pos < ring_count && ring_times[GetSlot(_pos)] == _time;
+  }
+
+  /**
+   * Returns tick with given timestamp or an empty one if it doesn't exist.
+   */
+  TickAB<TV> GetByKey(long _time) {
+    int _pos = LowerBoundSorted(_time);
+    if (_pos < ring_count && ring_times[GetSlot(_pos)] == _time) {
+      return ring_ticks[GetSlot(_pos)];
+    }
+    TickAB<TV> _empty;
+    return _empty;
+  }
+
+  /* Setters */
+
+  /**
+   * Sets maximum number of ticks kept. The oldest ticks above the limit are evicted.
+   */
+  void SetCapacity(int _capacity) {
+    ring_capacity = _capacity > 0 ? _capacity : 1;
+    while (ring_count > ring_capacity) {
+      EvictOldest();
+    }
+  }
+
   /**
    * Returns Ask prices ValueStorage proxy.
    */
@@ -130,39 +340,100 @@ class BufferTick : public BufferStruct<TickAB<TV>> {
     return _vs_bid;
   }
 
-  /* Grouping methods */
+  /* Time-sorted view */
 
   /**
-   * Group ticks by seconds.
+   * Returns number of ticks in the time-sorted view.
    */
-  DictStruct<unsigned int, DictStruct<unsigned int, TickAB<TV>>> GroupBySecs(unsigned int _spc) {
-    // DictStruct<unsigned int, DictStruct<TickAB<TV>>> _result;
-    // @todo: for each iter
-    // for (DictStructIterator<unsigned int, DictStruct<TickAB<TV>>> iter(Begin()); iter.IsValid(); ++iter) {
-    // Load timestamp from key, TickAB from value
-    // foreach some timestamp mod % _spc - calculate shift
-    // _result.Push(_shift, TickAB<TV>)
-    // Convert to OHLC in upper method
-    return NULL;
+  int GetSortedSize() { return ring_count; }
+
+  /**
+   * Returns timestamp of the tick at given position of the time-sorted view (0 is the oldest tick).
+   */
+  long GetSortedTime(int _pos) { return _pos >= 0 && _pos < ring_count ? ring_times[GetSlot(_pos)] : 0; }
+
+  /**
+   * Returns tick at given position of the time-sorted view (0 is the oldest tick).
+   */
+  TickAB<TV> GetSortedTick(int _pos) {
+    if (_pos < 0 || _pos >= ring_count) {
+      TickAB<TV> _empty;
+      return _empty;
+    }
+    return ring_ticks[GetSlot(_pos)];
+  }
+
+  /**
+   * Returns price of the tick at given position of the time-sorted view (0 is the oldest tick).
+   *
+   * @param _ap
+   *   PRICE_ASK or PRICE_BID.
+   */
+  TV GetSortedPrice(int _pos, int _ap) {
+    if (_pos < 0 || _pos >= ring_count) {
+      return (TV)0;
+    }
+    int _slot = GetSlot(_pos);
+    return _ap == PRICE_ASK ? ring_ticks[_slot].ask : ring_ticks[_slot].bid;
   }
 
-  /* Callback methods */
+  /* Grouping methods */
 
   /**
-   * Function should return true if resize can be made, or false to overwrite current slot.
+   * Group ticks by seconds.
+   *
+   * Ticks are swept once in time order. Subsequent calls with the same
+   * parameters only process ticks added (or changed) since the last call.
+   *
+   * @param _spc
+   *   Seconds per candle.
+   * @param _ap
+   *   PRICE_ASK or PRICE_BID.
+   *
+   * @return
+   *   Returns pointer to the reusable buffer of candles owned by this buffer.
    */
-  static bool BufferTickOverflowListener(ENUM_DICT_OVERFLOW_REASON _reason, int _size, int _num_conflicts) {
-    static int cache_limit = 86400;
-    switch (_reason) {
-      case DICT_OVERFLOW_REASON_FULL:
-        // We allow resize if dictionary size is less than 86400 slots.
-        return _size < cache_limit;
-      case DICT_OVERFLOW_REASON_TOO_MANY_CONFLICTS:
-      default:
-        // When there is too many conflicts, we just reject doing resize, so first conflicting slot will be reused.
-        break;
+  BufferCandle<TV> *GroupBySecs(unsigned int _spc, int _ap = PRICE_BID) {
+    if (_spc != grouped_spc || _ap != grouped_ap) {
+      grouped.Clear();
+      grouped_spc = _spc;
+      grouped_ap = _ap;
+      grouped_pos = 0;
     }
-    return false;
+
+    int _size = ring_count;
+    int _start = grouped_pos < sorted_changed_pos ? grouped_pos : sorted_changed_pos;
+    if (_start > 0 && _start < _size) {
+      // Regrouping the whole candle which covers the first changed tick.
+      long _start_time = ring_times[GetSlot(_start)];
+      _start = LowerBoundSorted(_start_time - _start_time % _spc);
+    }
+
+    long _candle_time = -1;
+    CandleOCTOHLC<TV> _candle;
+    for (int i = _start; i < _size; ++i) {
+      int _slot = GetSlot(i);
+      long _time = ring_times[_slot];
+      long _curr_candle_time = _time - _time % _spc;
+      TV _price = _ap == PRICE_ASK ? ring_ticks[_slot].ask : ring_ticks[_slot].bid;
+      if (_curr_candle_time != _candle_time) {
+        if (_candle_time != -1) {
+          grouped.Add(_candle, _candle_time);
+        }
+        CandleOCTOHLC<TV> _new_candle(_price, _price, _price, _price, _time, _time);
+        _candle = _new_candle;
+        _candle_time = _curr_candle_time;
+      } else {
+        _candle.Update(_time, _price);
+      }
+    }
+    if (_candle_time != -1) {
+      grouped.Add(_candle, _candle_time);
+    }
+
+    grouped_pos = _size;
+    sorted_changed_pos = INT_MAX;
+    return GetPointer(grouped);
   }
 };
 
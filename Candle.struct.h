@@ -241,6 +241,29 @@ struct CandleOCTOHLC : CandleOHLC<T> {
     low = MathMin(low, _price);
   }
 
+  // Merges OHLC values of other candle taking into consideration candles' timestamps.
+  void Merge(const CandleOCTOHLC<T> &_candle) {
+    if (_candle.open_timestamp == -1) {
+      // Other candle is empty.
+      return;
+    }
+    if (open_timestamp == -1) {
+      // This candle is empty, so we just copy the other one.
+      THIS_REF = _candle;
+      return;
+    }
+    if (_candle.open_timestamp < open_timestamp) {
+      open_timestamp = _candle.open_timestamp;
+      open = _candle.open;
+    }
+    if (_candle.close_timestamp > close_timestamp) {
+      close_timestamp = _candle.close_timestamp;
+      close = _candle.close;
+    }
+    high = MathMax(high, _candle.high);
+    low = MathMin(low, _candle.low);
+  }
+
   // Returns timestamp of open price.
   long GetOpenTimestamp() { return open_timestamp; }
 
@@ -0,0 +1,127 @@
+//+------------------------------------------------------------------+
+//|                                                EA31337 framework |
+//|                                 Copyright 2016-2022, EA31337 Ltd |
+//|                                       https://github.com/EA31337 |
+//+------------------------------------------------------------------+
+
+/*
+ * This file is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file
+ * Includes DealHistory's structs.
+ */
+
+#ifndef __MQL__
+// Allows the preprocessor to include a header file when it is needed.
+#pragma once
+#endif
+
+// Includes.
+#include "Deal.enum.h"
+#include "Std.h"
+
+/**
+ * Single deal record.
+ */
+struct DealEntry {
+  unsigned long ticket;   // Deal ticket.
+  unsigned long order;    // Order ticket which executed the deal.
+  datetime time;          // Time of the deal.
+  ENUM_DEAL_ENTRY entry;  // Deal entry (in, out, in/out or out by).
+  ENUM_DEAL_TYPE type;    // Deal type.
+  double volume;          // Volume of the deal.
+  double price;           // Price of the deal.
+  double commission;      // Commission of the deal.
+  double fee;             // Fee of the deal.
+  double swap;            // Cumulative swap on close.
+  double profit;          // Profit of the deal.
+  DealEntry()
+      : ticket(0),
+        order(0),
+        time(0),
+        entry(DEAL_ENTRY_IN),
+        type(DEAL_TYPE_BUY),
+        volume(0),
+        price(0),
+        commission(0),
+        fee(0),
+        swap(0),
+        profit(0) {}
+  // State methods.
+  bool IsIn() { return entry == DEAL_ENTRY_IN || entry == DEAL_ENTRY_INOUT; }
+  bool IsOut() { return entry == DEAL_ENTRY_OUT || entry == DEAL_ENTRY_OUT_BY || entry == DEAL_ENTRY_INOUT; }
+};
+
+/**
+ * Deals of a single position with their aggregated values.
+ */
+struct DealPositionEntry {
+  ARRAY(DealEntry, deals);  // Deals of the position (ordered by time).
+  datetime time_open;       // Time of the latest in deal.
+  datetime time_close;      // Time of the latest out deal.
+  double price_open;        // Price of the latest in deal.
+  double price_close;       // Price of the latest out deal.
+  double volume_in;         // Total volume of in deals.
+  double volume_out;        // Total volume of out deals.
+  double commission;        // Total commission.
+  double fee;               // Total fee.
+  double swap;              // Total swap.
+  double profit;            // Total profit.
+  bool is_loaded;           // Whether deals has been loaded from the history.
+  DealPositionEntry()
+      : time_open(0),
+        time_close(0),
+        price_open(0),
+        price_close(0),
+        volume_in(0),
+        volume_out(0),
+        commission(0),
+        fee(0),
+        swap(0),
+        profit(0),
+        is_loaded(false) {}
+  // Getters.
+  int GetDealsCount() { return ArraySize(deals); }
+  double GetTotalFees() { return commission + fee + swap; }
+  // State methods.
+  bool IsClosed() { return volume_in > 0 && volume_out >= volume_in; }
+  // Setters.
+  /**
+   * Adds deal and updates aggregated values.
+   *
+   * Deals aren't checked for duplicates, see DealHistory::HasDeal().
+   */
+  void Add(DealEntry &_deal) {
+    int _size = ArraySize(deals);
+    ArrayResize(deals, _size + 1, 4);
+    deals[_size] = _deal;
+    if (_deal.entry == DEAL_ENTRY_IN && _deal.time >= time_open) {
+      time_open = _deal.time;
+      price_open = _deal.price;
+    }
+    if ((_deal.entry == DEAL_ENTRY_OUT || _deal.entry == DEAL_ENTRY_OUT_BY) && _deal.time >= time_close) {
+      time_close = _deal.time;
+      price_close = _deal.price;
+    }
+    volume_in += _deal.IsIn() ? _deal.volume : 0;
+    volume_out += _deal.IsOut() ? _deal.volume : 0;
+    commission += _deal.commission;
+    fee += _deal.fee;
+    swap += _deal.swap;
+    profit += _deal.profit;
+  }
+};
@@ -0,0 +1,41 @@
+//+------------------------------------------------------------------+
+//|                                                EA31337 framework |
+//|                                 Copyright 2016-2022, EA31337 Ltd |
+//|                                       https://github.com/EA31337 |
+//+------------------------------------------------------------------+
+
+/*
+ * This file is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file
+ * Includes ExchangeSim's enums.
+ */
+
+#ifndef __MQL__
+// Allows the preprocessor to include a header file when it is needed.
+#pragma once
+#endif
+
+/* Defines states of the simulated order. */
+enum ENUM_EXCHANGE_SIM_ORDER_STATE {
+  EXCHANGE_SIM_ORDER_STATE_REQUESTED = 0,  // Market order waiting for the execution (latency).
+  EXCHANGE_SIM_ORDER_STATE_PENDING,        // Pending order waiting for the price.
+  EXCHANGE_SIM_ORDER_STATE_OPEN,           // Open position.
+  EXCHANGE_SIM_ORDER_STATE_CLOSING,        // Open position waiting for the close execution (latency).
+  EXCHANGE_SIM_ORDER_STATE_CLOSED,         // Closed position or cancelled order.
+  EXCHANGE_SIM_ORDER_STATE_REJECTED,       // Rejected order (e.g. not enough money).
+};
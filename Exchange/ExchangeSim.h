@@ -0,0 +1,539 @@
+//+------------------------------------------------------------------+
+//|                                                EA31337 framework |
+//|                                 Copyright 2016-2022, EA31337 Ltd |
+//|                                       https://github.com/EA31337 |
+//+------------------------------------------------------------------+
+
+/*
+ * This file is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// Prevents processing this includes file for the second time.
+#ifndef EXCHANGE_SIM_H
+#define EXCHANGE_SIM_H
+
+#ifndef __MQL__
+// Allows the preprocessor to include a header file when it is needed.
+#pragma once
+#endif
+
+// Includes.
+#include "../Account/AccountBase.struct.h"
+#include "../Account/AccountForex.struct.h"
+#include "../Refs.mqh"
+#include "ExchangeSim.struct.h"
+
+/**
+ * In-process simulated exchange for offline backtests.
+ *
+ * Orders are matched against the last bid/ask of their symbol. Market requests
+ * (opens and closes) are executed on the first tick after the latency has
+ * passed, with an adverse slippage drawn from a seeded generator, so runs with
+ * the same ticks and parameters are reproducible. Margin, swaps (charged on
+ * each day rollover of the symbol) and commissions are accounted in the
+ * deposit currency, which is assumed to be the quote currency of all symbols.
+ *
+ * Usage:
+ *
+ *   ExchangeSim _sim(ExchangeSimParams(10000, 100, 50, 2));
+ *   ExchangeSimSymbol _eurusd("EURUSD");
+ *   _sim.SymbolAdd(_eurusd);
+ *   unsigned long _ticket = _sim.OrderSend("EURUSD", ORDER_TYPE_BUY, 0.1);
+ *   _sim.OnTick("EURUSD", _time_msc, _bid, _ask);
+ *
+ * In the native build (without the terminal), Order's send, modify and close
+ * requests are executed by the Singleton<ExchangeSim> instance, see
+ * Order::OrderSendSim().
+ */
+class ExchangeSim : public Dynamic {
+ protected:
+  ARRAY(ExchangeSimSymbol, symbols);
+  ARRAY(ExchangeSimOrder, orders);   // Requested, pending and open orders.
+  ARRAY(ExchangeSimOrder, history);  // Closed, cancelled and rejected orders.
+  ExchangeSimParams params;
+  double balance;
+  unsigned long last_ticket;
+  unsigned long num_fills;
+  unsigned long num_ticks;
+  unsigned int rand_state;
+
+  /**
+   * Returns next pseudo-random number (xorshift32).
+   */
+  unsigned int Rand() {
+    rand_state ^= rand_state << 13;
+    rand_state ^= rand_state >> 17;
+    rand_state ^= rand_state << 5;
+    return rand_state;
+  }
+
+  /**
+   * Returns market execution price of the given direction including slippage.
+   */
+  double GetExecPrice(int _symbol, int _direction) {
+    double _slippage = params.slippage > 0 ? params.slippage * (Rand() % 1001) / 1000.0 : 0;
+    return _direction > 0 ? symbols[_symbol].ask + _slippage * symbols[_symbol].point
+                          : symbols[_symbol].bid - _slippage * symbols[_symbol].point;
+  }
+
+  /**
+   * Returns margin required for a given volume at a given price.
+   */
+  double GetMarginRequired(int _symbol, double _volume, double _price) {
+    return _volume * symbols[_symbol].contract_size * _price / params.leverage;
+  }
+
+  /**
+   * Opens position at a given price or rejects it when there is not enough free margin.
+   */
+  void Fill(ExchangeSimOrder &_order, double _price, long _time) {
+    double _commission = params.commission * _order.volume;
+    if (GetMarginRequired(_order.symbol, _order.volume, _price) + _commission > GetMarginFree()) {
+      _order.state = EXCHANGE_SIM_ORDER_STATE_REJECTED;
+      _order.time_close = _time;
+      return;
+    }
+    _order.state = EXCHANGE_SIM_ORDER_STATE_OPEN;
+    _order.price_open = _price;
+    _order.price_close = _price;
+    _order.time_open = _time;
+    _order.commission = _commission;
+    ++num_fills;
+  }
+
+  /**
+   * Closes position at a given price and realizes its profit.
+   */
+  void Close(ExchangeSimOrder &_order, double _price, long _time) {
+    _order.price_close = _price;
+    _order.profit = (_price - _order.price_open) * _order.GetDirection() * _order.volume *
+                    symbols[_order.symbol].contract_size;
+    _order.commission += params.commission * _order.volume;
+    _order.state = EXCHANGE_SIM_ORDER_STATE_CLOSED;
+    _order.time_close = _time;
+    balance += _order.GetTotalProfit();
+    ++num_fills;
+  }
+
+  /**
+   * Processes order of the symbol which has just received a tick.
+   */
+  void ProcessOrder(ExchangeSimOrder &_order, long _time) {
+    int _s = _order.symbol;
+    double _bid = symbols[_s].bid, _ask = symbols[_s].ask;
+    switch (_order.state) {
+      case EXCHANGE_SIM_ORDER_STATE_REQUESTED:
+        if (_time >= _order.time_exec) {
+          Fill(_order, GetExecPrice(_s, _order.GetDirection()), _time);
+        }
+        break;
+      case EXCHANGE_SIM_ORDER_STATE_PENDING:
+        switch (_order.type) {
+          case ORDER_TYPE_BUY_LIMIT:
+            if (_ask <= _order.price_request) Fill(_order, _order.price_request, _time);
+            break;
+          case ORDER_TYPE_SELL_LIMIT:
+            if (_bid >= _order.price_request) Fill(_order, _order.price_request, _time);
+            break;
+          case ORDER_TYPE_BUY_STOP:
+            if (_ask >= _order.price_request) Fill(_order, GetExecPrice(_s, 1), _time);
+            break;
+          case ORDER_TYPE_SELL_STOP:
+            if (_bid <= _order.price_request) Fill(_order, GetExecPrice(_s, -1), _time);
+            break;
+          default:
+            break;
+        }
+        break;
+      case EXCHANGE_SIM_ORDER_STATE_OPEN:
+        if (_order.IsBuy() ? (_order.sl > 0 && _bid <= _order.sl) || (_order.tp > 0 && _bid >= _order.tp)
+                           : (_order.sl > 0 && _ask >= _order.sl) || (_order.tp > 0 && _ask <= _order.tp)) {
+          Close(_order, _order.IsBuy() ? _bid : _ask, _time);
+        }
+        break;
+      case EXCHANGE_SIM_ORDER_STATE_CLOSING:
+        if (_time >= _order.time_exec) {
+          Close(_order, GetExecPrice(_s, -_order.GetDirection()), _time);
+        }
+        break;
+      default:
+        break;
+    }
+    if (_order.IsActive()) {
+      _order.price_close = _order.IsBuy() ? _bid : _ask;
+      _order.profit = (_order.price_close - _order.price_open) * _order.GetDirection() * _order.volume *
+                      symbols[_s].contract_size;
+    }
+  }
+
+  /**
+   * Closes the most losing positions while margin level is below the stop out level.
+   */
+  void ProcessStopOut(long _time) {
+    while (GetMargin() > 0 && GetMarginLevel() < params.stop_out) {
+      int _worst = -1;
+      for (int i = 0; i < ArraySize(orders); i++) {
+        if (orders[i].IsActive() && (_worst == -1 || orders[i].profit < orders[_worst].profit)) {
+          _worst = i;
+        }
+      }
+      if (_worst == -1) {
+        break;
+      }
+      Close(orders[_worst], orders[_worst].price_close, _time);
+    }
+  }
+
+  /**
+   * Moves closed and rejected orders into history (preserving order of remaining ones).
+   */
+  void MoveToHistory() {
+    int _size = ArraySize(orders), _left = 0;
+    for (int i = 0; i < _size; i++) {
+      if (orders[i].IsDone()) {
+        int _hsize = ArraySize(history);
+        ArrayResize(history, _hsize + 1, 1000);
+        history[_hsize] = orders[i];
+      } else {
+        if (_left != i) {
+          orders[_left] = orders[i];
+        }
+        _left++;
+      }
+    }
+    if (_left != _size) {
+      ArrayResize(orders, _left, 100);
+    }
+  }
+
+  /**
+   * Returns index of the active order with a given ticket or -1 if not found.
+   */
+  int GetOrderIndex(unsigned long _ticket) {
+    for (int i = 0; i < ArraySize(orders); i++) {
+      if (orders[i].ticket == _ticket) {
+        return i;
+      }
+    }
+    return -1;
+  }
+
+ public:
+  /**
+   * Class constructor.
+   */
+  ExchangeSim(const ExchangeSimParams &_params) : params(_params) { Reset(); }
+
+  /**
+   * Class constructor without parameters.
+   */
+  ExchangeSim() { Reset(); }
+
+  /* Account getters */
+
+  /**
+   * Returns balance (including realized profits, swaps and commissions).
+   */
+  double GetBalance() { return balance; }
+
+  /**
+   * Returns equity (balance plus floating result of open positions).
+   */
+  double GetEquity() { return balance + GetProfit(); }
+
+  /**
+   * Returns margin used by open positions.
+   */
+  double GetMargin() {
+    double _margin = 0;
+    for (int i = 0; i < ArraySize(orders); i++) {
+      if (orders[i].IsActive()) {
+        _margin += GetMarginRequired(orders[i].symbol, orders[i].volume, orders[i].price_open);
+      }
+    }
+    return _margin;
+  }
+
+  /**
+   * Returns free margin.
+   */
+  double GetMarginFree() { return GetEquity() - GetMargin(); }
+
+  /**
+   * Returns margin level (in %). Returns 0 if there are no open positions.
+   */
+  double GetMarginLevel() {
+    double _margin = GetMargin();
+    return _margin > 0 ? GetEquity() / _margin * 100 : 0;
+  }
+
+  /**
+   * Returns floating result of open positions (including swaps and commissions).
+   */
+  double GetProfit() {
+    double _profit = 0;
+    for (int i = 0; i < ArraySize(orders); i++) {
+      if (orders[i].IsActive()) {
+        _profit += orders[i].GetTotalProfit();
+      }
+    }
+    return _profit;
+  }
+
+  /**
+   * Returns account's state as an account entry.
+   */
+  AccountForexEntry GetAccountEntry() {
+    AccountForexEntry _entry;
+    _entry.dtime = (datetime)(GetTime() / 1000);
+    _entry.balance = GetBalance();
+    _entry.credit = 0;
+    _entry.equity = GetEquity();
+    _entry.profit = GetProfit();
+    _entry.margin_used = GetMargin();
+    _entry.margin_free = GetMarginFree();
+    _entry.margin_avail = GetMarginLevel();
+    return _entry;
+  }
+
+  /* Order getters */
+
+  /**
+   * Returns order with a given ticket (active or from history).
+   *
+   * @return
+   *   Returns order with zero ticket if not found.
+   */
+  ExchangeSimOrder GetOrder(unsigned long _ticket) {
+    int _index = GetOrderIndex(_ticket);
+    if (_index != -1) {
+      return orders[_index];
+    }
+    for (int i = ArraySize(history) - 1; i >= 0; i--) {
+      if (history[i].ticket == _ticket) {
+        return history[i];
+      }
+    }
+    ExchangeSimOrder _empty;
+    return _empty;
+  }
+
+  /**
+   * Returns number of requested, pending and open orders.
+   */
+  int GetOrdersCount() { return ArraySize(orders); }
+
+  /**
+   * Returns number of closed, cancelled and rejected orders.
+   */
+  int GetHistoryCount() { return ArraySize(history); }
+
+  /* Symbol getters */
+
+  /**
+   * Returns index of the symbol with a given name or -1 if not found.
+   */
+  int GetSymbolIndex(string _name) {
+    for (int i = 0; i < ArraySize(symbols); i++) {
+      if (symbols[i].name == _name) {
+        return i;
+      }
+    }
+    return -1;
+  }
+
+  /**
+   * Returns symbol at a given index.
+   */
+  ExchangeSimSymbol GetSymbol(int _index) { return symbols[_index]; }
+
+  /* Statistics */
+
+  /**
+   * Returns number of executions (opens and closes).
+   */
+  unsigned long GetFillsCount() { return num_fills; }
+
+  /**
+   * Returns number of processed ticks.
+   */
+  unsigned long GetTicksCount() { return num_ticks; }
+
+  /**
+   * Returns time of the most recent tick among all symbols (in ms).
+   */
+  long GetTime() {
+    long _time = 0;
+    for (int i = 0; i < ArraySize(symbols); i++) {
+      _time = symbols[i].time > _time ? symbols[i].time : _time;
+    }
+    return _time;
+  }
+
+  /* Symbol methods */
+
+  /**
+   * Adds symbol to the exchange.
+   *
+   * @return
+   *   Returns index of the symbol.
+   */
+  int SymbolAdd(ExchangeSimSymbol &_symbol) {
+    int _index = GetSymbolIndex(_symbol.name);
+    if (_index == -1) {
+      _index = ArraySize(symbols);
+      ArrayResize(symbols, _index + 1);
+    }
+    symbols[_index] = _symbol;
+    return _index;
+  }
+
+  /* Order methods */
+
+  /**
+   * Sends order request.
+   *
+   * Market orders are executed on the first tick after the latency. Pending
+   * orders (limit and stop) are executed when the price reaches _price.
+   *
+   * @return
+   *   Returns ticket of the order or 0 on invalid request.
+   */
+  unsigned long OrderSend(string _symbol, ENUM_ORDER_TYPE _type, double _volume, double _price = 0, double _sl = 0,
+                          double _tp = 0) {
+    int _s = GetSymbolIndex(_symbol);
+    bool _is_market = _type == ORDER_TYPE_BUY || _type == ORDER_TYPE_SELL;
+    bool _is_pending = _type == ORDER_TYPE_BUY_LIMIT || _type == ORDER_TYPE_SELL_LIMIT ||
+                       _type == ORDER_TYPE_BUY_STOP || _type == ORDER_TYPE_SELL_STOP;
+    if (_s == -1 || _volume <= 0 || (!_is_market && !_is_pending) || (_is_pending && _price <= 0)) {
+      SetUserError(ERR_INVALID_PARAMETER);
+      return 0;
+    }
+    int _size = ArraySize(orders);
+    ArrayResize(orders, _size + 1, 100);
+    orders[_size].ticket = ++last_ticket;
+    orders[_size].symbol = _s;
+    orders[_size].type = _type;
+    orders[_size].state = _is_market ? EXCHANGE_SIM_ORDER_STATE_REQUESTED : EXCHANGE_SIM_ORDER_STATE_PENDING;
+    orders[_size].volume = _volume;
+    orders[_size].price_request = _price;
+    orders[_size].sl = _sl;
+    orders[_size].tp = _tp;
+    orders[_size].time_request = symbols[_s].time;
+    orders[_size].time_exec = symbols[_s].time + params.latency;
+    return last_ticket;
+  }
+
+  /**
+   * Requests close of the position or cancels requested or pending order.
+   */
+  bool OrderClose(unsigned long _ticket) {
+    int _index = GetOrderIndex(_ticket);
+    if (_index == -1) {
+      return false;
+    }
+    long _time = symbols[orders[_index].symbol].time;
+    switch (orders[_index].state) {
+      case EXCHANGE_SIM_ORDER_STATE_OPEN:
+        orders[_index].state = EXCHANGE_SIM_ORDER_STATE_CLOSING;
+        orders[_index].time_exec = _time + params.latency;
+        return true;
+      case EXCHANGE_SIM_ORDER_STATE_REQUESTED:
+      case EXCHANGE_SIM_ORDER_STATE_PENDING:
+        orders[_index].state = EXCHANGE_SIM_ORDER_STATE_CLOSED;
+        orders[_index].time_close = _time;
+        MoveToHistory();
+        return true;
+      default:
+        break;
+    }
+    return false;
+  }
+
+  /**
+   * Modifies stop loss and take profit of the order.
+   */
+  bool OrderModify(unsigned long _ticket, double _sl, double _tp) {
+    int _index = GetOrderIndex(_ticket);
+    if (_index == -1 || orders[_index].IsDone()) {
+      return false;
+    }
+    orders[_index].sl = _sl;
+    orders[_index].tp = _tp;
+    return true;
+  }
+
+  /* Main methods */
+
+  /**
+   * Processes tick of a given symbol.
+   *
+   * @param _time
+   *   Time of the tick (in ms). Ticks of each symbol should come in order.
+   */
+  void OnTick(int _symbol, long _time, double _bid, double _ask) {
+    long _day_prev = symbols[_symbol].time / 86400000;
+    symbols[_symbol].bid = _bid;
+    symbols[_symbol].ask = _ask;
+    symbols[_symbol].time = _time;
+    ++num_ticks;
+
+    bool _rollover = num_ticks > 1 && _time / 86400000 > _day_prev;
+    bool _done = false;
+    for (int i = 0; i < ArraySize(orders); i++) {
+      if (orders[i].symbol != _symbol) {
+        continue;
+      }
+      if (_rollover && orders[i].IsActive()) {
+        orders[i].swap +=
+            (orders[i].IsBuy() ? symbols[_symbol].swap_long : symbols[_symbol].swap_short) * orders[i].volume;
+      }
+      ProcessOrder(orders[i], _time);
+      _done |= orders[i].IsDone();
+    }
+    if (params.stop_out > 0) {
+      ProcessStopOut(_time);
+      _done = true;
+    }
+    if (_done) {
+      MoveToHistory();
+    }
+  }
+
+  /**
+   * Processes tick of a given symbol.
+   */
+  void OnTick(string _symbol, long _time, double _bid, double _ask) {
+    int _s = GetSymbolIndex(_symbol);
+    if (_s != -1) {
+      OnTick(_s, _time, _bid, _ask);
+    }
+  }
+
+  /**
+   * Removes all orders and restores initial balance. Symbols are kept.
+   */
+  void Reset() {
+    ArrayResize(orders, 0);
+    ArrayResize(history, 0);
+    balance = params.balance;
+    last_ticket = 0;
+    num_fills = 0;
+    num_ticks = 0;
+    rand_state = params.seed != 0 ? params.seed : 1;
+  }
+};
+
+#endif  // EXCHANGE_SIM_H
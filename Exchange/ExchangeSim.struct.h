@@ -0,0 +1,129 @@
+//+------------------------------------------------------------------+
+//|                                                EA31337 framework |
+//|                                 Copyright 2016-2022, EA31337 Ltd |
+//|                                       https://github.com/EA31337 |
+//+------------------------------------------------------------------+
+
+/*
+ * This file is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file
+ * Includes ExchangeSim's structs.
+ */
+
+#ifndef __MQL__
+// Allows the preprocessor to include a header file when it is needed.
+#pragma once
+#endif
+
+// Includes.
+#include "../Order.enum.h"
+#include "ExchangeSim.enum.h"
+
+/* Defines struct for simulated exchange parameters. */
+struct ExchangeSimParams {
+  double balance;     // Initial balance (in deposit currency).
+  double commission;  // Commission per lot, charged on open and on close.
+  long latency;       // Delay between order request and its execution (in ms).
+  double leverage;    // Account leverage.
+  unsigned int seed;  // Seed of the slippage generator.
+  double slippage;    // Maximum slippage of market executions (in points).
+  double stop_out;    // Margin level (in %) at which the most losing position is closed.
+  // Constructors.
+  ExchangeSimParams(double _balance = 10000, double _leverage = 100, long _latency = 0, double _slippage = 0,
+                    double _commission = 0, double _stop_out = 50, unsigned int _seed = 1)
+      : balance(_balance),
+        commission(_commission),
+        latency(_latency),
+        leverage(_leverage),
+        seed(_seed),
+        slippage(_slippage),
+        stop_out(_stop_out) {}
+};
+
+/* Defines struct for simulated symbol. */
+struct ExchangeSimSymbol {
+  string name;
+  double ask;
+  double bid;
+  double contract_size;  // Number of units per lot.
+  double point;
+  double swap_long;   // Swap per lot per day for buy positions (in deposit currency).
+  double swap_short;  // Swap per lot per day for sell positions (in deposit currency).
+  long time;          // Time of the last tick (in ms).
+  // Constructors.
+  ExchangeSimSymbol(string _name = "", double _point = 0.00001, double _contract_size = 100000,
+                    double _swap_long = 0, double _swap_short = 0)
+      : name(_name),
+        ask(0),
+        bid(0),
+        contract_size(_contract_size),
+        point(_point),
+        swap_long(_swap_long),
+        swap_short(_swap_short),
+        time(0) {}
+};
+
+/* Defines struct for simulated order. */
+struct ExchangeSimOrder {
+  unsigned long ticket;
+  int symbol;  // Index of the symbol.
+  ENUM_ORDER_TYPE type;
+  ENUM_EXCHANGE_SIM_ORDER_STATE state;
+  double volume;
+  double price_request;  // Requested price of pending order.
+  double price_open;
+  double price_close;
+  double sl;
+  double tp;
+  double commission;
+  double swap;
+  double profit;
+  long time_request;  // Time of the request (in ms).
+  long time_exec;     // Time when the pending request (open or close) executes (in ms).
+  long time_open;
+  long time_close;
+  // Constructors.
+  ExchangeSimOrder()
+      : ticket(0),
+        symbol(-1),
+        type(ORDER_TYPE_BUY),
+        state(EXCHANGE_SIM_ORDER_STATE_REQUESTED),
+        volume(0),
+        price_request(0),
+        price_open(0),
+        price_close(0),
+        sl(0),
+        tp(0),
+        commission(0),
+        swap(0),
+        profit(0),
+        time_request(0),
+        time_exec(0),
+        time_open(0),
+        time_close(0) {}
+  /* Getters */
+  int GetDirection() { return IsBuy() ? 1 : -1; }
+  double GetTotalProfit() { return profit + swap - commission; }
+  bool IsActive() {
+    return state == EXCHANGE_SIM_ORDER_STATE_OPEN || state == EXCHANGE_SIM_ORDER_STATE_CLOSING;
+  }
+  bool IsBuy() { return type == ORDER_TYPE_BUY || type == ORDER_TYPE_BUY_LIMIT || type == ORDER_TYPE_BUY_STOP; }
+  bool IsDone() {
+    return state == EXCHANGE_SIM_ORDER_STATE_CLOSED || state == EXCHANGE_SIM_ORDER_STATE_REJECTED;
+  }
+};
@@ -22,8 +22,9 @@
 
 // Defines.
 #ifndef __MQL__
-// File constants to read the whole value of char, short or int type.
+// File constants to read the whole value of char, short, int or double type.
 #define CHAR_VALUE 1
+#define DOUBLE_VALUE 8
 #define INT_VALUE 4
 #define SHORT_VALUE 2
 // Used for checking file handles (see FileOpen() and FileFindFirst()).
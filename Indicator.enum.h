@@ -116,6 +116,7 @@ enum ENUM_INDICATOR_TYPE {
   INDI_TEMA,                            // Triple Exponential Moving Average
   INDI_TF,                              // Timeframe
   INDI_TICK,                            // Tick
+  INDI_TICK_VOLATILITY,                 // Tick Volatility
   INDI_TMA_TRUE,                        // Triangular Moving Average True
   INDI_TRIX,                            // Triple Exponential Moving Averages Oscillator
   INDI_ULTIMATE_OSCILLATOR,             // Ultimate Oscillator
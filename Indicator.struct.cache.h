@@ -31,8 +31,23 @@
 #endif
 
 // Includes.
+#include "File.mqh"
 #include "Refs.mqh"
+#include "Storage/FractalsStream.h"
+#include "Storage/RollingDiffs.h"
+#include "Storage/RollingPeak.h"
+#include "Storage/RollingStats.h"
 #include "Storage/ValueStorage.h"
+#include "Storage/ValueStorage.native.h"
+#include "Storage/ValueStorage.time.h"
+#include "Storage/ZigZagStream.h"
+
+// Defines.
+#define INDICATOR_CALCULATE_CACHE_SNAPSHOT_VERSION 1
+#ifndef INDICATOR_SNAPSHOTS_DIR
+// Directory (within the common files folder) to store indicator snapshots.
+#define INDICATOR_SNAPSHOTS_DIR "EA31337-snapshots\\"
+#endif
 
 /**
  * Holds buffers used to cache values calculated via OnCalculate methods.
@@ -64,12 +79,36 @@ class IndicatorCalculateCache : public Dynamic {
   // Buffer to store input close prices. Won't be deleted!
   ValueStorage<C> *price_close_buffer;
 
+  // Buffer of bar times used to validate snapshots. Won't be deleted!
+  ValueStorage<datetime> *time_buffer;
+
   // Buffers used for OnCalculate calculations.
   ARRAY(IValueStorage *, buffers);
 
   // Auxiliary caches related to this one.
   ARRAY(IndicatorCalculateCache<C> *, subcaches);
 
+  // Rolling statistics kept between calculations.
+  ARRAY(RollingStats *, rolling_stats);
+  ARRAY(RollingDiffs *, rolling_diffs);
+  ARRAY(RollingPeak *, rolling_peaks);
+
+  // Streaming calculations kept between calculations.
+  ARRAY(ZigZagStream *, zigzag_streams);
+  ARRAY(FractalsStream *, fractals_streams);
+
+  // File to save snapshot into on destruction. Empty if snapshots are disabled.
+  string snapshot_file;
+
+  // Whether restored snapshot awaits validation against input prices.
+  bool snapshot_pending;
+
+  // Number of calculated values stored in the restored snapshot.
+  int snapshot_prev_calculated;
+
+  // History checksum stored in the restored snapshot.
+  unsigned long snapshot_checksum;
+
   /**
    * Constructor.
    */
@@ -77,6 +116,15 @@ class IndicatorCalculateCache : public Dynamic {
     prev_calculated = 0;
     total = 0;
     initialized = false;
+    price_buffer = NULL;
+    price_open_buffer = NULL;
+    price_high_buffer = NULL;
+    price_low_buffer = NULL;
+    price_close_buffer = NULL;
+    time_buffer = NULL;
+    snapshot_pending = false;
+    snapshot_prev_calculated = 0;
+    snapshot_checksum = 0;
     Resize(_buffers_size);
   }
 
@@ -86,6 +134,10 @@ class IndicatorCalculateCache : public Dynamic {
   ~IndicatorCalculateCache() {
     int i;
 
+    if (snapshot_file != "") {
+      SaveSnapshot(snapshot_file);
+    }
+
     for (i = 0; i < ArraySize(buffers); ++i) {
       if (buffers[i] != NULL) {
         delete buffers[i];
@@ -97,6 +149,36 @@ class IndicatorCalculateCache : public Dynamic {
         delete subcaches[i];
       }
     }
+
+    for (i = 0; i < ArraySize(rolling_stats); ++i) {
+      if (rolling_stats[i] != NULL) {
+        delete rolling_stats[i];
+      }
+    }
+
+    for (i = 0; i < ArraySize(rolling_diffs); ++i) {
+      if (rolling_diffs[i] != NULL) {
+        delete rolling_diffs[i];
+      }
+    }
+
+    for (i = 0; i < ArraySize(rolling_peaks); ++i) {
+      if (rolling_peaks[i] != NULL) {
+        delete rolling_peaks[i];
+      }
+    }
+
+    for (i = 0; i < ArraySize(zigzag_streams); ++i) {
+      if (zigzag_streams[i] != NULL) {
+        delete zigzag_streams[i];
+      }
+    }
+
+    for (i = 0; i < ArraySize(fractals_streams); ++i) {
+      if (fractals_streams[i] != NULL) {
+        delete fractals_streams[i];
+      }
+    }
   }
 
   /**
@@ -130,11 +212,106 @@ class IndicatorCalculateCache : public Dynamic {
 
     if (subcaches[index] == NULL) {
       subcaches[index] = new IndicatorCalculateCache();
+      subcaches[index].SetTimeBuffer(time_buffer);
     }
 
     return subcaches[index];
   }
 
+  /**
+   * Returns existing or new rolling statistics with a given window's length.
+   *
+   * @param _track_mad
+   *   Whether statistics should also provide mean absolute deviation.
+   */
+  RollingStats *GetRollingStats(int _index, int _period, bool _track_mad = false) {
+    if (_index >= ArraySize(rolling_stats)) {
+      ArrayResize(rolling_stats, _index + 1, 10);
+    }
+
+    if (rolling_stats[_index] == NULL) {
+      rolling_stats[_index] = new RollingStats(_period, _track_mad);
+    } else if (rolling_stats[_index].GetPeriod() != _period) {
+      rolling_stats[_index].SetPeriod(_period);
+    }
+
+    return rolling_stats[_index];
+  }
+
+  /**
+   * Returns existing or new rolling sums of differences with a given number of differences.
+   */
+  RollingDiffs *GetRollingDiffs(int _index, int _period) {
+    if (_index >= ArraySize(rolling_diffs)) {
+      ArrayResize(rolling_diffs, _index + 1, 10);
+    }
+
+    if (rolling_diffs[_index] == NULL) {
+      rolling_diffs[_index] = new RollingDiffs(_period);
+    } else if (rolling_diffs[_index].GetPeriod() != _period) {
+      rolling_diffs[_index].SetPeriod(_period);
+    }
+
+    return rolling_diffs[_index];
+  }
+
+  /**
+   * Returns existing or new rolling highest or lowest value with a given window's length.
+   */
+  RollingPeak *GetRollingPeak(int _index, int _period, ENUM_IPEAK _type) {
+    if (_index >= ArraySize(rolling_peaks)) {
+      ArrayResize(rolling_peaks, _index + 1, 10);
+    }
+
+    if (rolling_peaks[_index] == NULL || rolling_peaks[_index].GetType() != _type) {
+      if (rolling_peaks[_index] != NULL) {
+        delete rolling_peaks[_index];
+      }
+      rolling_peaks[_index] = new RollingPeak(_period, _type);
+    } else if (rolling_peaks[_index].GetPeriod() != _period) {
+      rolling_peaks[_index].SetPeriod(_period);
+    }
+
+    return rolling_peaks[_index];
+  }
+
+  /**
+   * Returns existing or new streaming ZigZag calculation with given parameters.
+   */
+  ZigZagStream *GetZigZagStream(int _index, int _depth, int _deviation, int _backstep, double _point) {
+    if (_index >= ArraySize(zigzag_streams)) {
+      ArrayResize(zigzag_streams, _index + 1, 10);
+    }
+
+    if (zigzag_streams[_index] != NULL &&
+        (zigzag_streams[_index].GetDepth() != _depth || zigzag_streams[_index].GetDeviation() != _deviation ||
+         zigzag_streams[_index].GetBackstep() != _backstep || zigzag_streams[_index].GetPoint() != _point)) {
+      delete zigzag_streams[_index];
+      zigzag_streams[_index] = NULL;
+    }
+
+    if (zigzag_streams[_index] == NULL) {
+      zigzag_streams[_index] = new ZigZagStream(_depth, _deviation, _backstep, _point);
+    }
+
+    return zigzag_streams[_index];
+  }
+
+  /**
+   * Returns existing or new streaming Fractals calculation.
+   */
+  FractalsStream *GetFractalsStream(int _index) {
+    if (_index >= ArraySize(fractals_streams)) {
+      ArrayResize(fractals_streams, _index + 1, 10);
+    }
+
+    if (fractals_streams[_index] == NULL) {
+      fractals_streams[_index] = new FractalsStream();
+    }
+
+    return fractals_streams[_index];
+  }
+
   /**
    * Add buffer of the given type. Usage: AddBuffer<NativeBuffer>()
    */
@@ -194,6 +371,8 @@ class IndicatorCalculateCache : public Dynamic {
 
     // Cache is ready to be used.
     initialized = true;
+
+    ValidateSnapshot();
   }
 
   /**
@@ -214,6 +393,20 @@ class IndicatorCalculateCache : public Dynamic {
 
     // Cache is ready to be used.
     initialized = true;
+
+    ValidateSnapshot();
+  }
+
+  /**
+   * Sets buffer of bar times for snapshot validation. Subcaches share the same buffer.
+   */
+  void SetTimeBuffer(ValueStorage<datetime> *_time) {
+    time_buffer = _time;
+    for (int i = 0; i < ArraySize(subcaches); ++i) {
+      if (subcaches[i] != NULL) {
+        subcaches[i].SetTimeBuffer(_time);
+      }
+    }
   }
 
   /**
@@ -263,4 +456,134 @@ class IndicatorCalculateCache : public Dynamic {
    * Returns prev_calculated value used by indicator's OnCalculate method.
    */
   int GetPrevCalculated(int _prev_calculated) { return prev_calculated; }
+
+  /* Snapshot methods */
+
+  /**
+   * Returns snapshot's file name for a given cache key.
+   */
+  static string GetSnapshotFileName(const ObjectsKey &_key) {
+    return INDICATOR_SNAPSHOTS_DIR + "cache_" + IntegerToString((long)_key.hash) + ".bin";
+  }
+
+  /**
+   * Calculates checksum of the bar times and input prices of the first given number of bars.
+   */
+  unsigned long GetHistoryChecksum(int _count) {
+    ObjectsKey _checksum;
+    ValueStorage<C> *_prices = price_buffer != NULL ? price_buffer : price_close_buffer;
+    _checksum.Add(_count);
+    if (_prices == NULL) {
+      return _checksum.hash;
+    }
+    for (int i = 0; i < _count; ++i) {
+      if (time_buffer != NULL) {
+        _checksum.Add((long)time_buffer.Fetch(i));
+      }
+      _checksum.Add((double)_prices.Fetch(i));
+    }
+    return _checksum.hash;
+  }
+
+  /**
+   * Writes calculated buffers into the binary file.
+   */
+  bool SaveSnapshot(int _handle) {
+    // The newest calculated value may come from an incomplete bar, so it is calculated again after restore.
+    int _prev_calculated = MathMax(0, MathMin(prev_calculated, total) - 1);
+    FileWriteInteger(_handle, _prev_calculated);
+    FileWriteLong(_handle, (long)GetHistoryChecksum(_prev_calculated));
+    FileWriteInteger(_handle, ArraySize(buffers));
+    for (int i = 0; i < ArraySize(buffers); ++i) {
+      if (!((NativeValueStorage<C> *)buffers[i]).Save(_handle)) {
+        return false;
+      }
+    }
+    FileWriteInteger(_handle, ArraySize(subcaches));
+    for (int i = 0; i < ArraySize(subcaches); ++i) {
+      FileWriteInteger(_handle, subcaches[i] != NULL ? 1 : 0);
+      if (subcaches[i] != NULL && !subcaches[i].SaveSnapshot(_handle)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /**
+   * Saves snapshot into the given file.
+   */
+  bool SaveSnapshot(string _file) {
+    if (!initialized || prev_calculated <= 1) {
+      // Nothing worth saving.
+      return false;
+    }
+    int _handle = FileOpen(_file, FILE_WRITE | FILE_BIN | FILE_COMMON);
+    if (_handle == INVALID_HANDLE) {
+      return false;
+    }
+    FileWriteInteger(_handle, INDICATOR_CALCULATE_CACHE_SNAPSHOT_VERSION);
+    bool _result = SaveSnapshot(_handle);
+    FileClose(_handle);
+    return _result;
+  }
+
+  /**
+   * Reads buffers written by SaveSnapshot(). Buffers are used after input prices are validated.
+   */
+  bool LoadSnapshot(int _handle) {
+    snapshot_prev_calculated = FileReadInteger(_handle);
+    snapshot_checksum = (unsigned long)FileReadLong(_handle);
+    int _num_buffers = FileReadInteger(_handle);
+    if (_num_buffers < 0 || (HasBuffers() && _num_buffers != NumBuffers())) {
+      return false;
+    }
+    if (!HasBuffers()) {
+      // Calculation buffers are always native ones.
+      AddBuffer<NativeValueStorage<C>>(_num_buffers);
+    }
+    for (int i = 0; i < _num_buffers; ++i) {
+      if (!((NativeValueStorage<C> *)buffers[i]).Load(_handle)) {
+        return false;
+      }
+    }
+    int _num_subcaches = FileReadInteger(_handle);
+    for (int i = 0; i < _num_subcaches; ++i) {
+      if (FileReadInteger(_handle) != 0 && !GetSubCache(i).LoadSnapshot(_handle)) {
+        return false;
+      }
+    }
+    snapshot_pending = true;
+    return true;
+  }
+
+  /**
+   * Restores snapshot from the given file. Snapshot will be saved into the same file on destruction.
+   */
+  bool LoadSnapshot(string _file) {
+    snapshot_file = _file;
+    if (!FileIsExist(_file, FILE_COMMON)) {
+      return false;
+    }
+    int _handle = FileOpen(_file, FILE_READ | FILE_BIN | FILE_COMMON);
+    if (_handle == INVALID_HANDLE) {
+      return false;
+    }
+    bool _result = FileReadInteger(_handle) == INDICATOR_CALCULATE_CACHE_SNAPSHOT_VERSION && LoadSnapshot(_handle);
+    FileClose(_handle);
+    snapshot_pending = _result;
+    return _result;
+  }
+
+  /**
+   * Resumes calculation from the restored snapshot if input prices didn't change since it has been saved.
+   */
+  void ValidateSnapshot() {
+    if (!snapshot_pending) {
+      return;
+    }
+    snapshot_pending = false;
+    if (snapshot_prev_calculated <= total && GetHistoryChecksum(snapshot_prev_calculated) == snapshot_checksum) {
+      prev_calculated = snapshot_prev_calculated;
+    }
+  }
 };
@@ -53,6 +53,7 @@ template <typename TS, typename TV>
 class IndicatorCandle : public Indicator<TS> {
  protected:
   BufferCandle<TV> icdata;
+  ARRAY(long, icdata_times);  // Ordered (ascending) open times of candles stored in icdata.
 
  protected:
   /* Protected methods */
@@ -69,6 +70,61 @@ class IndicatorCandle : public Indicator<TS> {
     icdata.SetOverflowListener(IndicatorCandleOverflowListener, 10);
   }
 
+  /**
+   * Returns position of the first candle in the ordered index which opened at or after given time.
+   */
+  int LowerBoundCandleTime(long _candle_time) {
+    int _lo = 0, _hi = ArraySize(icdata_times);
+    while (_lo < _hi) {
+      int _mid = (_lo + _hi) / 2;
+      if (icdata_times[_mid] < _candle_time) {
+        _lo = _mid + 1;
+      } else {
+        _hi = _mid;
+      }
+    }
+    return _lo;
+  }
+
+  /**
+   * Adds candle's open time into the ordered index of candles.
+   */
+  void IndexCandleTime(long _candle_time) {
+    int _size = ArraySize(icdata_times);
+    if (_size == 0 || icdata_times[_size - 1] < _candle_time) {
+      // The most common case, candle is the newest one.
+      ArrayResize(icdata_times, _size + 1, 4096);
+      icdata_times[_size] = _candle_time;
+      return;
+    }
+    int _pos = LowerBoundCandleTime(_candle_time);
+    if (icdata_times[_pos] == _candle_time) {
+      // Already indexed.
+      return;
+    }
+    ArrayResize(icdata_times, _size + 1, 4096);
+    for (int i = _size; i > _pos; --i) {
+      icdata_times[i] = icdata_times[i - 1];
+    }
+    icdata_times[_pos] = _candle_time;
+  }
+
+  /**
+   * Removes candle's open time from the ordered index of candles.
+   */
+  void UnindexCandleTime(long _candle_time) {
+    int _size = ArraySize(icdata_times);
+    int _pos = LowerBoundCandleTime(_candle_time);
+    if (_pos == _size || icdata_times[_pos] != _candle_time) {
+      // Not indexed.
+      return;
+    }
+    for (int i = _pos; i < _size - 1; ++i) {
+      icdata_times[i] = icdata_times[i + 1];
+    }
+    ArrayResize(icdata_times, _size - 1, 4096);
+  }
+
  public:
   /* Special methods */
 
@@ -98,34 +154,18 @@ class IndicatorCandle : public Indicator<TS> {
    */
   IndicatorDataEntry GetEntry(int _index = -1) override {
     ResetLastError();
-    unsigned int _ishift = _index >= 0 ? _index : iparams.GetShift();
-    long _candle_time = CalcCandleTimestamp(GetBarTime(_ishift));
-    long _curr_candle_time;
+    int _ishift = _index >= 0 ? _index : iparams.GetShift();
+    long _candle_time = GetBarTime(_ishift);
     CandleOCTOHLC<TV> _candle;
 
-    // Trying current and older shifts.
-    if (icdata.Size() > 0) {
-      int i = 0;
-      while (true) {
-        _curr_candle_time = CalcCandleTimestamp(GetBarTime(i++));
-
-        if (_curr_candle_time < icdata.GetMin()) {
-          // There is no older entries.
-          break;
-        }
-
-        _candle = icdata.GetByKey(_curr_candle_time);
-
-        if (_candle.IsValid()) {
-          break;
-        }
-      }
+    if (_candle_time != -1) {
+      _candle = icdata.GetByKey(_candle_time);
     }
 
     if (!_candle.IsValid()) {
       // Giving up.
       DebugBreak();
-      Print(GetFullName(), ": Missing candle after thorough search at shift ", _index, " (", TimeToString(_candle_time),
+      Print(GetFullName(), ": Missing candle at shift ", _index, " (", TimeToString(_candle_time),
             "). Lowest timestamp in history is ", icdata.GetMin());
     }
 
@@ -152,8 +192,10 @@ class IndicatorCandle : public Indicator<TS> {
    * Sends historic entries to listening indicators. May be overriden.
    */
   void EmitHistory() override {
-    for (DictStructIterator<long, CandleOCTOHLC<TV>> iter(icdata.Begin()); iter.IsValid(); ++iter) {
-      IndicatorDataEntry _entry = CandleToEntry(iter.Key(), iter.Value());
+    // Emitting candles from the oldest to the newest one.
+    for (int i = 0; i < ArraySize(icdata_times); ++i) {
+      CandleOCTOHLC<TV> _candle = icdata.GetByKey(icdata_times[i]);
+      IndicatorDataEntry _entry = CandleToEntry(icdata_times[i], _candle);
       EmitEntry(_entry);
     }
   }
@@ -188,9 +230,21 @@ class IndicatorCandle : public Indicator<TS> {
       // Candle already exists.
       _candle = icdata.GetByKey(_candle_timestamp);
       _candle.Update(_tick_timestamp, _price);
+      icdata.Add(_candle, _candle_timestamp);
+      return;
     }
 
     icdata.Add(_candle, _candle_timestamp);
+    if (!icdata.KeyExists(_candle_timestamp)) {
+      // Overflow listener has rejected resize of icdata.
+      return;
+    }
+    IndexCandleTime(_candle_timestamp);
+    long _overwritten_time;
+    if (icdata.GetOverwrittenKey(_overwritten_time)) {
+      // Overflow listener doesn't resize icdata after it reaches its limit, so the new candle took slot of other one.
+      UnindexCandleTime(_overwritten_time);
+    }
   }
 
   /**
@@ -200,6 +254,50 @@ class IndicatorCandle : public Indicator<TS> {
     return _tick_timestamp - _tick_timestamp % (iparams.GetSecsPerCandle());
   }
 
+  /* Timeseries */
+
+  /**
+   * Returns open time of the chart's bar for given timeframe.
+   */
+  datetime GetBarTime(ENUM_TIMEFRAMES _tf, unsigned int _shift = 0) { return Chart::GetBarTime(_tf, _shift); }
+
+  /**
+   * Returns open time of the candle at given shift or -1 if there is no such candle.
+   */
+  datetime GetBarTime(unsigned int _shift = 0) override {
+    int _size = ArraySize(icdata_times);
+    return (int)_shift < _size ? (datetime)icdata_times[_size - 1 - _shift] : (datetime)-1;
+  }
+
+  /**
+   * Returns the number of candles.
+   */
+  int GetBars() override { return ArraySize(icdata_times); }
+
+  /**
+   * Returns index of the newest candle (counted from the oldest one).
+   */
+  unsigned int GetBarIndex() { return GetBars() > 0 ? GetBars() - 1 : 0; }
+
+  /**
+   * Search for a candle by its time.
+   *
+   * Returns shift of the candle which covers the specified time or -1 if there is no such candle.
+   *
+   * @param _exact
+   *   When false and there is no candle covering given time, shift of the nearest older candle is returned.
+   */
+  int GetBarShift(datetime _time, bool _exact = false) override {
+    long _candle_time = CalcCandleTimestamp(_time);
+    int _size = ArraySize(icdata_times);
+    // Position of the newest candle opened at or before given time.
+    int _pos = LowerBoundCandleTime(_candle_time + 1) - 1;
+    if (_pos < 0 || (_exact && icdata_times[_pos] != _candle_time)) {
+      return -1;
+    }
+    return _size - 1 - _pos;
+  }
+
   /**
    * Called when data source emits new entry (historic or future one).
    */
@@ -0,0 +1,339 @@
+//+------------------------------------------------------------------+
+//|                                                EA31337 framework |
+//|                                 Copyright 2016-2022, EA31337 Ltd |
+//|                                       https://github.com/EA31337 |
+//+------------------------------------------------------------------+
+
+/*
+ *  This file is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+// Ignore processing of this file if already included.
+#ifndef INDICATOR_EXPRESSION_H
+#define INDICATOR_EXPRESSION_H
+
+#ifndef __MQL__
+// Allows the preprocessor to include a header file when it is needed.
+#pragma once
+#endif
+
+// Includes.
+#include "../IndicatorData.mqh"
+#include "../Math.h"
+#include "../Refs.mqh"
+
+// Types of expression's nodes.
+enum ENUM_INDICATOR_EXPRESSION_NODE {
+  INDI_EXPR_NODE_CONST,    // Constant value.
+  INDI_EXPR_NODE_OPERAND,  // Indicator's value (mode and shift).
+  INDI_EXPR_NODE_OP        // Math operation over one or two nodes.
+};
+
+/**
+ * Arithmetic expression over values of many indicators.
+ *
+ * Nodes are added bottom-up and the whole tree is evaluated in a single pass,
+ * so intermediate results never go through indicator's entries as in chained
+ * Indi_Math instances. Equal operands (indicator, mode and shift) and equal
+ * subexpressions are added only once, so each of them is fetched or calculated
+ * once per bar.
+ *
+ * Range evaluation calculates one node for all bars before moving to the next
+ * node, so each indicator is read for consecutive bars in one loop.
+ *
+ * Result is EMPTY_VALUE when any of the used values is EMPTY_VALUE or when
+ * dividing by zero.
+ *
+ * Usage:
+ *
+ *   // (fast MA - slow MA) / ATR.
+ *   IndicatorExpression _expr;
+ *   int _diff = _expr.Op(MATH_OP_SUB, _expr.Operand(_ma_fast), _expr.Operand(_ma_slow));
+ *   _expr.SetRoot(_expr.Op(MATH_OP_DIV, _diff, _expr.Operand(_atr)));
+ *   double _value = _expr.Evaluate(1);
+ */
+class IndicatorExpression : public Dynamic {
+ protected:
+  // Nodes.
+  ARRAY(int, node_types);  // Node's type (ENUM_INDICATOR_EXPRESSION_NODE).
+  ARRAY(int, node_ops);    // Node's math operation (ENUM_MATH_OP).
+  ARRAY(int, node_args1);  // First argument's node or operand's index.
+  ARRAY(int, node_args2);  // Second argument's node or -1 for unary operations.
+  ARRAY(double, node_consts);
+  ARRAY(double, node_values);  // Node values of the lastly evaluated bar or bars.
+  // Operands.
+  ARRAY(Ref<IndicatorData>, operand_indis);
+  ARRAY(int, operand_modes);
+  ARRAY(int, operand_shifts);
+  // Nodes needed to calculate the root, in order of calculation.
+  ARRAY(int, program);
+  int root;
+  bool is_compiled;
+  unsigned long num_fetches;
+
+  /**
+   * Adds new node.
+   */
+  int AddNode(ENUM_INDICATOR_EXPRESSION_NODE _type, int _op, int _arg1, int _arg2, double _const) {
+    int _node = ArraySize(node_types);
+    ArrayResize(node_types, _node + 1, 16);
+    ArrayResize(node_ops, _node + 1, 16);
+    ArrayResize(node_args1, _node + 1, 16);
+    ArrayResize(node_args2, _node + 1, 16);
+    ArrayResize(node_consts, _node + 1, 16);
+    node_types[_node] = _type;
+    node_ops[_node] = _op;
+    node_args1[_node] = _arg1;
+    node_args2[_node] = _arg2;
+    node_consts[_node] = _const;
+    is_compiled = false;
+    return _node;
+  }
+
+  /**
+   * Finds existing node of given properties. Returns -1 if not found.
+   */
+  int FindNode(ENUM_INDICATOR_EXPRESSION_NODE _type, int _op, int _arg1, int _arg2, double _const) {
+    for (int i = 0; i < ArraySize(node_types); ++i) {
+      if (node_types[i] == _type && node_ops[i] == _op && node_args1[i] == _arg1 && node_args2[i] == _arg2 &&
+          node_consts[i] == _const) {
+        return i;
+      }
+    }
+    return -1;
+  }
+
+  /**
+   * Appends given node and its arguments into program (children first).
+   */
+  void CompileNode(int _node, ARRAY_REF(int, _visited)) {
+    if (_visited[_node]) {
+      return;
+    }
+    _visited[_node] = 1;
+    if (node_types[_node] == INDI_EXPR_NODE_OP) {
+      CompileNode(node_args1[_node], _visited);
+      if (node_args2[_node] != -1) {
+        CompileNode(node_args2[_node], _visited);
+      }
+    }
+    int _size = ArraySize(program);
+    ArrayResize(program, _size + 1, 16);
+    program[_size] = _node;
+  }
+
+  /**
+   * Builds list of nodes needed to calculate the root.
+   */
+  void Compile() {
+    ArrayResize(program, 0);
+    if (GetRoot() != -1) {
+      ARRAY(int, _visited);
+      ArrayResize(_visited, ArraySize(node_types));
+      ArrayInitialize(_visited, 0);
+      CompileNode(GetRoot(), _visited);
+    }
+    is_compiled = true;
+  }
+
+  /**
+   * Fetches operand's value for a given shift.
+   */
+  double Fetch(int _operand, int _shift) {
+    ++num_fetches;
+    IndicatorData *_indi = operand_indis[_operand].Ptr();
+    return PTR_ATTRIB(_indi, GetValue<double>(operand_modes[_operand], _shift + operand_shifts[_operand]));
+  }
+
+  /**
+   * Calculates math operation.
+   */
+  static double Calc(ENUM_MATH_OP _op, double _value1, double _value2) {
+    if (_value1 == EMPTY_VALUE || _value2 == EMPTY_VALUE || (_op == MATH_OP_DIV && _value2 == 0)) {
+      return EMPTY_VALUE;
+    }
+    return Math::Op(_op, _value1, _value2);
+  }
+
+  /**
+   * Calculates node's value from already calculated values of its arguments.
+   *
+   * @param _size
+   *   Number of values per node (bars).
+   * @param _index
+   *   Index of the value (bar).
+   */
+  double CalcNode(int _node, int _size, int _index) {
+    double _value1 = node_values[node_args1[_node] * _size + _index];
+    // Unary operations get the argument as both values.
+    double _value2 = node_args2[_node] != -1 ? node_values[node_args2[_node] * _size + _index] : _value1;
+    return Calc((ENUM_MATH_OP)node_ops[_node], _value1, _value2);
+  }
+
+  /**
+   * Calculates values of all needed nodes for a range of shifts, one node at a time.
+   *
+   * @return
+   *   Returns false if there is nothing to calculate.
+   */
+  bool Run(int _shift_from, int _size) {
+    if (!is_compiled) {
+      Compile();
+    }
+    if (ArraySize(program) == 0 || _size <= 0) {
+      return false;
+    }
+    ArrayResize(node_values, GetNumNodes() * _size);
+    for (int p = 0; p < ArraySize(program); ++p) {
+      int i, _node = program[p], _offset = _node * _size;
+      switch (node_types[_node]) {
+        case INDI_EXPR_NODE_CONST:
+          for (i = 0; i < _size; ++i) {
+            node_values[_offset + i] = node_consts[_node];
+          }
+          break;
+        case INDI_EXPR_NODE_OPERAND:
+          for (i = 0; i < _size; ++i) {
+            node_values[_offset + i] = Fetch(node_args1[_node], _shift_from + i);
+          }
+          break;
+        case INDI_EXPR_NODE_OP:
+          for (i = 0; i < _size; ++i) {
+            node_values[_offset + i] = CalcNode(_node, _size, i);
+          }
+          break;
+      }
+    }
+    return true;
+  }
+
+ public:
+  /* Special methods */
+
+  /**
+   * Class constructor.
+   */
+  IndicatorExpression() : root(-1), is_compiled(false), num_fetches(0) {}
+
+  /* Getters */
+
+  /**
+   * Returns number of distinct nodes.
+   */
+  int GetNumNodes() { return ArraySize(node_types); }
+
+  /**
+   * Returns number of distinct operands.
+   */
+  int GetNumOperands() { return ArraySize(operand_modes); }
+
+  /**
+   * Returns number of operands' values fetched from indicators so far.
+   */
+  unsigned long GetNumFetches() { return num_fetches; }
+
+  /**
+   * Returns root node or the lastly added node if root wasn't set. Returns -1 if expression is empty.
+   */
+  int GetRoot() { return root != -1 ? root : GetNumNodes() - 1; }
+
+  /* Setters */
+
+  /**
+   * Sets node which value is the result of the expression.
+   */
+  void SetRoot(int _node) {
+    root = _node;
+    is_compiled = false;
+  }
+
+  /* Nodes */
+
+  /**
+   * Adds constant value.
+   *
+   * @return
+   *   Returns node.
+   */
+  int Const(double _value) {
+    int _node = FindNode(INDI_EXPR_NODE_CONST, 0, -1, -1, _value);
+    return _node != -1 ? _node : AddNode(INDI_EXPR_NODE_CONST, 0, -1, -1, _value);
+  }
+
+  /**
+   * Adds indicator's value.
+   *
+   * @param _shift
+   *   Shift added to the evaluated shift.
+   *
+   * @return
+   *   Returns node.
+   */
+  int Operand(IndicatorData *_indi, int _mode = 0, int _shift = 0) {
+    int _operand;
+    for (_operand = 0; _operand < GetNumOperands(); ++_operand) {
+      if (operand_indis[_operand].Ptr() == _indi && operand_modes[_operand] == _mode &&
+          operand_shifts[_operand] == _shift) {
+        return FindNode(INDI_EXPR_NODE_OPERAND, 0, _operand, -1, 0);
+      }
+    }
+    ArrayResize(operand_indis, _operand + 1, 8);
+    ArrayResize(operand_modes, _operand + 1, 8);
+    ArrayResize(operand_shifts, _operand + 1, 8);
+    operand_indis[_operand] = _indi;
+    operand_modes[_operand] = _mode;
+    operand_shifts[_operand] = _shift;
+    return AddNode(INDI_EXPR_NODE_OPERAND, 0, _operand, -1, 0);
+  }
+
+  /**
+   * Adds math operation over one or two nodes.
+   *
+   * @return
+   *   Returns node.
+   */
+  int Op(ENUM_MATH_OP _op, int _node1, int _node2 = -1) {
+    int _node = FindNode(INDI_EXPR_NODE_OP, _op, _node1, _node2, 0);
+    return _node != -1 ? _node : AddNode(INDI_EXPR_NODE_OP, _op, _node1, _node2, 0);
+  }
+
+  /* Main methods */
+
+  /**
+   * Evaluates expression for a given shift.
+   */
+  double Evaluate(int _shift = 0) { return Run(_shift, 1) ? node_values[GetRoot()] : EMPTY_VALUE; }
+
+  /**
+   * Evaluates expression for a range of shifts.
+   *
+   * @param _out
+   *   Results, where index 0 is the result for _shift_from.
+   *
+   * @return
+   *   Returns number of evaluated shifts.
+   */
+  int Evaluate(int _shift_from, int _shift_to, ARRAY_REF(double, _out)) {
+    int _size = _shift_to - _shift_from + 1;
+    if (!Run(_shift_from, _size)) {
+      return 0;
+    }
+    ArrayResize(_out, _size);
+    ArrayCopy(_out, node_values, 0, GetRoot() * _size, _size);
+    return _size;
+  }
+};
+
+#endif  // INDICATOR_EXPRESSION_H
@@ -0,0 +1,182 @@
+//+------------------------------------------------------------------+
+//|                                                EA31337 framework |
+//|                                 Copyright 2016-2022, EA31337 Ltd |
+//|                                       https://github.com/EA31337 |
+//+------------------------------------------------------------------+
+
+/*
+ *  This file is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+// Ignore processing of this file if already included.
+#ifndef INDICATOR_INTERNER_H
+#define INDICATOR_INTERNER_H
+
+#ifndef __MQL__
+// Allows the preprocessor to include a header file when it is needed.
+#pragma once
+#endif
+
+// Includes.
+#include "../IndicatorData.mqh"
+#include "../Refs.mqh"
+#include "../Storage/ObjectsByKey.h"
+#include "../Storage/ObjectsKey.h"
+
+/**
+ * Holds reference to the interned indicator.
+ */
+class IndicatorInternerEntry : public Dynamic {
+ public:
+  Ref<IndicatorData> indi;
+  int num_requests;
+
+  /**
+   * Class constructor.
+   */
+  IndicatorInternerEntry(IndicatorData* _indi) : num_requests(1) { indi = _indi; }
+};
+
+/**
+ * Shares equal indicators between their users (e.g. strategies).
+ *
+ * Indicators are equal when they have the same type, symbol, timeframe, data source type, data source (instance and
+ * mode) and parameters. Parameters are compared by their serialized form, so parameters' struct needs to serialize
+ * all of its fields.
+ *
+ * Usage:
+ *
+ *   IndiRSIParams _params(14, PRICE_CLOSE);
+ *   Indi_RSI* _rsi = IndicatorInterner::GetInstance().Intern(new Indi_RSI(_params));
+ *   // Returned indicator is either the given one or an equal one interned before (given one is deleted then).
+ */
+class IndicatorInterner {
+ protected:
+  ObjectsByKey<IndicatorInternerEntry> entries;
+  int num_requests;
+  int num_collapsed;
+
+ public:
+  /* Special methods */
+
+  /**
+   * Class constructor.
+   */
+  IndicatorInterner() : num_requests(0), num_collapsed(0) {}
+
+  /**
+   * Returns interner shared by the whole program.
+   */
+  static IndicatorInterner* GetInstance() {
+    static IndicatorInterner _instance;
+    return &_instance;
+  }
+
+  /* Getters */
+
+  /**
+   * Returns number of distinct indicators.
+   */
+  int GetNumIndicators() { return entries.Size(); }
+
+  /**
+   * Returns number of Intern() calls.
+   */
+  int GetNumRequests() { return num_requests; }
+
+  /**
+   * Returns number of indicators which were replaced by an equal, already interned one.
+   */
+  int GetNumCollapsed() { return num_collapsed; }
+
+  /**
+   * Returns statistics as text.
+   */
+  string GetStatsText() {
+    return "Interned indicators: " + IntegerToString(GetNumIndicators()) + " distinct of " +
+           IntegerToString(num_requests) + " requested, " + IntegerToString(num_collapsed) + " duplicates collapsed.";
+  }
+
+  /* Main methods */
+
+  /**
+   * Returns key which identifies given indicator.
+   */
+  static ObjectsKey MakeKey(IndicatorData* _indi) {
+    IndicatorBase* _source = _indi.GetDataSourceRaw();
+    ObjectsKey _key =
+        ObjectsKey::Make((int)_indi.GetType(), _indi.GetParamsText(), _indi.GetSymbol(), (int)_indi.GetTf());
+    _key.Add((int)_indi.Get<ENUM_IDATA_SOURCE_TYPE>(STRUCT_ENUM(IndicatorDataParams, IDATA_PARAM_IDSTYPE)));
+    _key.Add(_source != NULL ? _source.GetInstanceId() : -1);
+    _key.Add(_indi.Get<int>(STRUCT_ENUM(IndicatorDataParams, IDATA_PARAM_SRC_MODE)));
+    return _key;
+  }
+
+  /**
+   * Returns given indicator or an equal one interned before.
+   *
+   * Given indicator is released (thus deleted when nothing else references it) when an equal one is returned.
+   */
+  template <typename T>
+  T* Intern(T* _indi) {
+    // Takes ownership of the given indicator if nothing references it yet.
+    Ref<IndicatorData> _ref = _indi;
+    ObjectsKey _key = MakeKey(_indi);
+    IndicatorInternerEntry* _entry;
+    ++num_requests;
+    if (entries.TryGet(_key, _entry)) {
+      ++num_collapsed;
+      ++_entry.num_requests;
+      return (T*)_entry.indi.Ptr();
+    }
+    entries.Set(_key, new IndicatorInternerEntry(_indi));
+    return _indi;
+  }
+
+  /**
+   * Releases interned indicators which aren't referenced outside of the interner anymore.
+   *
+   * @return
+   *   Returns number of released indicators.
+   */
+  int Evict() {
+    int _evicted = 0;
+    int _num_evicted;
+    do {
+      // Released indicator may have been the last user of another interned one (e.g. its data source).
+      _num_evicted = 0;
+      for (int i = 0; i < entries.GetNumEntries(); ++i) {
+        IndicatorInternerEntry* _entry = entries.GetByEntry(i);
+        if (_entry != NULL && _entry.indi.Ptr().ptr_ref_counter.num_strong_refs <= 1) {
+          entries.EvictEntry(i);
+          ++_num_evicted;
+        }
+      }
+      _evicted += _num_evicted;
+    } while (_num_evicted > 0);
+    return _evicted;
+  }
+
+  /**
+   * Releases all interned indicators. Indicators still referenced elsewhere aren't deleted.
+   */
+  void Clear() {
+    entries.Clear();
+    num_requests = 0;
+    num_collapsed = 0;
+  }
+};
+
+#endif  // INDICATOR_INTERNER_H
@@ -0,0 +1,259 @@
+//+------------------------------------------------------------------+
+//|                                                EA31337 framework |
+//|                                 Copyright 2016-2022, EA31337 Ltd |
+//|                                       https://github.com/EA31337 |
+//+------------------------------------------------------------------+
+
+/*
+ * This file is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// Ignore processing of this file if already included.
+#ifndef INDICATOR_PROJECTION_H
+#define INDICATOR_PROJECTION_H
+
+#ifndef __MQL__
+// Allows the preprocessor to include a header file when it is needed.
+#pragma once
+#endif
+
+// Includes.
+#include "../IndicatorData.mqh"
+#include "../Refs.mqh"
+
+/**
+ * Projects entries of higher-timeframe indicator onto lower-timeframe bars.
+ *
+ * Higher-timeframe (HTF) entries are fetched only when HTF bar boundary is
+ * crossed, which is detected from the tick's time, so no HTF history lookups
+ * are made between boundaries. Closed HTF entries are kept in a ring and every
+ * lower-timeframe (LTF) bar remembers serial number of the HTF bar it belongs
+ * to, so LTF shift is mapped to HTF entry in O(1).
+ *
+ * Entry of the in-progress HTF bar is fetched once per LTF bar.
+ *
+ * Only LTF bars processed by Update() are mapped directly. Older bars are
+ * resolved by the HTF indicator's bar search.
+ *
+ * Usage:
+ *
+ *   IndicatorProjection _h4(indi_ma_h4.Ptr(), PERIOD_M1);
+ *   // On each tick.
+ *   _h4.Update(TimeCurrent());
+ *   double _ma = _h4.GetEntry(_shift, true)[0];
+ */
+class IndicatorProjection : public Dynamic {
+ protected:
+  Ref<IndicatorData> indi;            // Higher-timeframe indicator.
+  ENUM_TIMEFRAMES ltf;                // Lower timeframe.
+  ENUM_TIMEFRAMES htf;                // Higher timeframe.
+  unsigned int ltf_secs;              // Seconds per LTF bar.
+  unsigned int htf_secs;              // Seconds per HTF bar.
+  long ltf_time;                      // Open time of the current LTF bar.
+  long htf_time;                      // Open time of the current HTF bar.
+  long htf_serial;                    // Serial number of the current HTF bar.
+  IndicatorDataEntry current;         // Entry of the in-progress HTF bar.
+  bool is_current_set;                // Whether current entry has been fetched for the current LTF bar.
+  ARRAY(IndicatorDataEntry, closed);  // Ring of closed HTF entries.
+  int closed_head;                    // Position of the last closed HTF entry.
+  int closed_count;
+  ARRAY(long, serials);               // Ring of HTF serial numbers per LTF bar.
+  int serials_head;                   // Position of the current LTF bar.
+  int serials_count;
+  int capacity;
+  unsigned long num_fetches;
+
+  /**
+   * Calculates open time of the bar of a given timeframe which covers given time.
+   */
+  static long CalcBarTime(ENUM_TIMEFRAMES _tf, unsigned int _secs, long _time) {
+    switch (_tf) {
+      case PERIOD_W1:
+        // Weekly bars start on Sunday. Epoch started on Thursday.
+        return _time - (_time + 4 * 86400) % (7 * 86400);
+      case PERIOD_MN1: {
+        MqlDateTime _dt;
+        TimeToStruct((datetime)_time, _dt);
+        _dt.day = 1;
+        _dt.hour = 0;
+        _dt.min = 0;
+        _dt.sec = 0;
+        return (long)StructToTime(_dt);
+      }
+    }
+    return _secs > 0 ? _time - _time % _secs : _time;
+  }
+
+  /**
+   * Fetches entry from the HTF indicator.
+   */
+  IndicatorDataEntry Fetch(int _htf_shift) {
+    ++num_fetches;
+    return indi.Ptr().GetEntry(_htf_shift);
+  }
+
+ public:
+  /* Special methods */
+
+  /**
+   * Class constructor.
+   *
+   * @param _indi
+   *   Higher-timeframe indicator.
+   * @param _ltf
+   *   Lower timeframe which shifts are mapped.
+   * @param _capacity
+   *   Number of closed HTF entries and LTF bars kept.
+   */
+  IndicatorProjection(IndicatorData* _indi, ENUM_TIMEFRAMES _ltf = PERIOD_CURRENT, int _capacity = 10000)
+      : ltf(_ltf), num_fetches(0) {
+    indi = _indi;
+    htf = indi.Ptr().GetTf();
+    ltf_secs = ChartTf::TfToSeconds(ltf);
+    htf_secs = ChartTf::TfToSeconds(htf);
+    capacity = _capacity > 0 ? _capacity : 1;
+    ArrayResize(closed, capacity);
+    ArrayResize(serials, capacity);
+    Clear();
+  }
+
+  /* Getters */
+
+  /**
+   * Returns higher-timeframe indicator.
+   */
+  IndicatorData* GetIndicator() { return indi.Ptr(); }
+
+  /**
+   * Returns open time of the current HTF bar or -1 if no tick has been processed.
+   */
+  long GetHtfTime() { return htf_time; }
+
+  /**
+   * Returns number of HTF bars started since the projection started.
+   */
+  long GetNumHtfBars() { return htf_serial; }
+
+  /**
+   * Returns number of entries fetched from the HTF indicator.
+   */
+  unsigned long GetNumFetches() { return num_fetches; }
+
+  /**
+   * Returns HTF shift of the bar covering given LTF bar.
+   *
+   * @return
+   *   Returns HTF shift or -1 if LTF bar couldn't be found.
+   */
+  int GetHtfShift(int _ltf_shift) {
+    if (_ltf_shift >= 0 && _ltf_shift < serials_count) {
+      return (int)(htf_serial - serials[(serials_head - _ltf_shift + capacity) % capacity]);
+    }
+    datetime _time = ChartStatic::iTime(indi.Ptr().GetSymbol(), ltf, _ltf_shift);
+    return _time > 0 ? indi.Ptr().GetBarShift(_time) : -1;
+  }
+
+  /**
+   * Returns entry of the in-progress HTF bar.
+   */
+  IndicatorDataEntry GetCurrent() {
+    if (!is_current_set) {
+      current = Fetch(0);
+      is_current_set = true;
+    }
+    return current;
+  }
+
+  /**
+   * Returns entry of HTF bar at given HTF shift.
+   */
+  IndicatorDataEntry GetHtfEntry(int _htf_shift) {
+    if (_htf_shift == 0 && htf_time != -1) {
+      return GetCurrent();
+    }
+    if (_htf_shift > 0 && _htf_shift <= closed_count) {
+      return closed[(closed_head - _htf_shift + 1 + capacity) % capacity];
+    }
+    return Fetch(_htf_shift);
+  }
+
+  /**
+   * Returns the last closed HTF entry.
+   */
+  IndicatorDataEntry GetLastClosed() { return GetHtfEntry(1); }
+
+  /**
+   * Returns HTF entry projected onto given LTF bar.
+   *
+   * @param _closed
+   *   When true, returns entry of the HTF bar closed before the given LTF bar,
+   *   so projected values never change after the LTF bar is closed.
+   */
+  IndicatorDataEntry GetEntry(int _ltf_shift = 0, bool _closed = false) {
+    int _htf_shift = GetHtfShift(_ltf_shift);
+    if (_htf_shift < 0) {
+      IndicatorDataEntry _invalid;
+      return _invalid;
+    }
+    return GetHtfEntry(_closed ? _htf_shift + 1 : _htf_shift);
+  }
+
+  /* Main methods */
+
+  /**
+   * Processes tick's time. Should be called on every tick before entries are read.
+   *
+   * @return
+   *   Returns true when new HTF bar has started.
+   */
+  bool Update(long _time) {
+    long _htf_time = CalcBarTime(htf, htf_secs, _time);
+    long _ltf_time = CalcBarTime(ltf, ltf_secs, _time);
+    bool _is_new_htf = _htf_time > htf_time;
+    if (_is_new_htf) {
+      // Previous HTF bar has been closed, so its entry won't change anymore.
+      closed_head = (closed_head + 1) % capacity;
+      closed[closed_head] = Fetch(1);
+      closed_count = closed_count < capacity ? closed_count + 1 : capacity;
+      htf_time = _htf_time;
+      ++htf_serial;
+      is_current_set = false;
+    }
+    if (_ltf_time > ltf_time) {
+      serials_head = (serials_head + 1) % capacity;
+      serials[serials_head] = htf_serial;
+      serials_count = serials_count < capacity ? serials_count + 1 : capacity;
+      ltf_time = _ltf_time;
+      is_current_set = false;
+    }
+    return _is_new_htf;
+  }
+
+  /**
+   * Drops cached entries and mapped LTF bars.
+   */
+  void Clear() {
+    ltf_time = -1;
+    htf_time = -1;
+    htf_serial = 0;
+    is_current_set = false;
+    closed_head = -1;
+    closed_count = 0;
+    serials_head = -1;
+    serials_count = 0;
+  }
+};
+
+#endif  // INDICATOR_PROJECTION_H
@@ -33,6 +33,7 @@
 #include "../Chart.struct.tf.h"
 #include "IndicatorCandle.h"
 #include "IndicatorTf.struct.h"
+#include "IndicatorTfAggregator.h"
 
 /**
  * Class to deal with candle indicators.
@@ -40,6 +41,10 @@
 template <typename TFP>
 class IndicatorTf : public IndicatorCandle<TFP, double> {
  protected:
+  Ref<IndicatorTfAggregator> aggregator;  // Shared multi-timeframe aggregator (optional).
+  int aggregator_level;                   // Aggregator's level matching indicator's timeframe.
+  int aggregator_subscriber_id;
+
   /* Protected methods */
 
   /**
@@ -47,7 +52,10 @@ class IndicatorTf : public IndicatorCandle<TFP, double> {
    *
    * Called on constructor.
    */
-  void Init() {}
+  void Init() {
+    aggregator_level = -1;
+    aggregator_subscriber_id = -1;
+  }
 
  public:
   /* Special methods */
@@ -83,6 +91,125 @@ class IndicatorTf : public IndicatorCandle<TFP, double> {
       : IndicatorCandle<TFP, double>(_icparams, _idparams) {
     Init();
   }
+
+  /**
+   * Class deconstructor.
+   */
+  ~IndicatorTf() {
+    if (aggregator.IsSet()) {
+      aggregator.Ptr().Unsubscribe(aggregator_subscriber_id);
+    }
+  }
+
+  /* Setters */
+
+  /**
+   * Makes indicator use candles from the shared multi-timeframe aggregator instead of its own buffer.
+   *
+   * All indicators sharing the aggregator should use the same tick source. Ticks are fed into the aggregator only
+   * once, no matter how many indicators use it.
+   */
+  void SetAggregator(IndicatorTfAggregator* _aggregator) {
+    if (aggregator.IsSet()) {
+      aggregator.Ptr().Unsubscribe(aggregator_subscriber_id);
+    }
+    aggregator = _aggregator;
+    if (_aggregator != NULL) {
+      aggregator_level = _aggregator.AddTf(iparams.GetSecsPerCandle());
+      aggregator_subscriber_id = _aggregator.Subscribe();
+    } else {
+      aggregator_level = -1;
+      aggregator_subscriber_id = -1;
+    }
+  }
+
+  /* Getters */
+
+  /**
+   * Returns shared multi-timeframe aggregator or NULL if not used.
+   */
+  IndicatorTfAggregator* GetAggregator() { return aggregator.Ptr(); }
+
+  /* Timeseries */
+
+  /**
+   * Returns open time of the chart's bar for given timeframe.
+   */
+  datetime GetBarTime(ENUM_TIMEFRAMES _tf, unsigned int _shift = 0) { return Chart::GetBarTime(_tf, _shift); }
+
+  /**
+   * Returns open time of the candle at given shift or -1 if there is no such candle.
+   */
+  datetime GetBarTime(unsigned int _shift = 0) override {
+    return aggregator.IsSet() ? (datetime)aggregator.Ptr().GetCandleTime(aggregator_level, _shift)
+                              : IndicatorCandle<TFP, double>::GetBarTime(_shift);
+  }
+
+  /**
+   * Returns the number of candles.
+   */
+  int GetBars() override {
+    return aggregator.IsSet() ? aggregator.Ptr().GetCandlesCount(aggregator_level)
+                              : IndicatorCandle<TFP, double>::GetBars();
+  }
+
+  /**
+   * Search for a candle by its time.
+   *
+   * Returns shift of the candle which covers the specified time or -1 if there is no such candle.
+   */
+  int GetBarShift(datetime _time, bool _exact = false) override {
+    return aggregator.IsSet() ? aggregator.Ptr().GetShiftByTime(aggregator_level, _time, _exact)
+                              : IndicatorCandle<TFP, double>::GetBarShift(_time, _exact);
+  }
+
+  /* Virtual method implementations */
+
+  /**
+   * Returns the indicator's data entry.
+   *
+   * @see: IndicatorDataEntry.
+   *
+   * @return
+   *   Returns IndicatorDataEntry struct filled with indicator values.
+   */
+  IndicatorDataEntry GetEntry(int _index = -1) override {
+    if (!aggregator.IsSet()) {
+      return IndicatorCandle<TFP, double>::GetEntry(_index);
+    }
+    ResetLastError();
+    int _ishift = _index >= 0 ? _index : iparams.GetShift();
+    CandleOCTOHLC<double> _candle = aggregator.Ptr().GetCandle(aggregator_level, _ishift);
+    return CandleToEntry(aggregator.Ptr().GetCandleTime(aggregator_level, _ishift), _candle);
+  }
+
+  /**
+   * Sends historic entries to listening indicators.
+   */
+  void EmitHistory() override {
+    if (!aggregator.IsSet()) {
+      IndicatorCandle<TFP, double>::EmitHistory();
+      return;
+    }
+    for (int _shift = aggregator.Ptr().GetCandlesCount(aggregator_level) - 1; _shift >= 0; --_shift) {
+      IndicatorDataEntry _entry = GetEntry(_shift);
+      EmitEntry(_entry);
+    }
+  }
+
+  /**
+   * Called when data source emits new entry (historic or future one).
+   */
+  void OnDataSourceEntry(IndicatorDataEntry& entry) override {
+    if (!aggregator.IsSet()) {
+      IndicatorCandle<TFP, double>::OnDataSourceEntry(entry);
+      return;
+    }
+    if (aggregator.Ptr().IsFeeder(aggregator_subscriber_id)) {
+      // Updating candles from bid price.
+      aggregator.Ptr().OnTick(entry.timestamp, entry[1]);
+    }
+  }
 };
 
 #endif
@@ -49,4 +49,12 @@ struct IndicatorTfParams : IndicatorParams {
       tf.SetTf(_tf);
     }
   }
+  // Serializers.
+  SerializerNodeType Serialize(Serializer &s) {
+    s.Pass(THIS_REF, "spc", spc);
+    s.Enter(SerializerEnterObject);
+    IndicatorParams::Serialize(s);
+    s.Leave();
+    return SerializerNodeObject;
+  }
 };
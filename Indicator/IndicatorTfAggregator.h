@@ -0,0 +1,394 @@
+//+------------------------------------------------------------------+
+//|                                                EA31337 framework |
+//|                                 Copyright 2016-2022, EA31337 Ltd |
+//|                                       https://github.com/EA31337 |
+//+------------------------------------------------------------------+
+
+/*
+ * This file is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// Ignore processing of this file if already included.
+#ifndef INDICATOR_TF_AGGREGATOR_H
+#define INDICATOR_TF_AGGREGATOR_H
+
+#ifndef __MQL__
+// Allows the preprocessor to include a header file when it is needed.
+#pragma once
+#endif
+
+// Includes.
+#include "../Buffer/BufferCandleRing.h"
+#include "../Refs.mqh"
+
+/**
+ * Multi-timeframe tick-to-candle aggregator.
+ *
+ * Tick updates only the finest candle. Completed candles are rolled up into
+ * coarser timeframes, so each tick costs O(1) regardless of the number of
+ * timeframes. Timeframe which period isn't a multiple of any finer timeframe
+ * is fed directly by ticks.
+ *
+ * Newest candle of a coarser timeframe stores only rolled-up candles, the
+ * in-progress part is merged from finer timeframes when the candle is read.
+ *
+ * Usage:
+ *
+ *   Ref<IndicatorTfAggregator> _aggregator = new IndicatorTfAggregator();
+ *   indi_m1.Ptr().SetAggregator(_aggregator.Ptr());
+ *   indi_m5.Ptr().SetAggregator(_aggregator.Ptr());
+ */
+class IndicatorTfAggregator : public Dynamic {
+ protected:
+  ARRAY(BufferCandleRing<double>*, rings);  // Output ring per level.
+  ARRAY(unsigned int, spcs);                // Seconds per candle per level.
+  ARRAY(int, parents);                      // Level which feeds given level or -1 if fed by ticks.
+  int capacity;                             // Capacity of newly created rings.
+  int feeder_id;                            // Subscriber which feeds ticks.
+  int last_subscriber_id;
+  unsigned long num_ticks;
+
+  /**
+   * Calculates candle's timestamp for a given level.
+   */
+  long CalcCandleTimestamp(int _level, long _timestamp) { return _timestamp - _timestamp % spcs[_level]; }
+
+  /**
+   * Recalculates which level feeds each level.
+   */
+  void UpdateParents() {
+    for (int i = 0; i < ArraySize(spcs); ++i) {
+      parents[i] = -1;
+      unsigned int _parent_spc = 0;
+      for (int j = 0; j < ArraySize(spcs); ++j) {
+        // Finding the coarsest finer level which period divides given level's period.
+        if (spcs[j] < spcs[i] && spcs[i] % spcs[j] == 0 && spcs[j] > _parent_spc) {
+          parents[i] = j;
+          _parent_spc = spcs[j];
+        }
+      }
+    }
+  }
+
+  /**
+   * Adds tick's price to the given level which is fed by ticks.
+   */
+  void UpdateLevel(int _level, long _timestamp, double _price) {
+    BufferCandleRing<double>* _ring = rings[_level];
+    long _candle_time = CalcCandleTimestamp(_level, _timestamp);
+    long _newest_time = _ring.GetNewestTime();
+
+    if (_candle_time == _newest_time) {
+      // The most common case, tick updates the current candle.
+      _ring.UpdateByShift(0, _timestamp, _price);
+      return;
+    }
+
+    if (_candle_time < _newest_time) {
+      // Late tick. Updating already completed candles, which have been rolled up into coarser levels.
+      for (int _ilevel = _level; _ilevel != -1; _ilevel = GetChildOrDescendant(_level, _ilevel)) {
+        long _itime = CalcCandleTimestamp(_ilevel, _timestamp);
+        int _shift = rings[_ilevel].GetShiftByTime(_itime);
+        if (_shift == -1) {
+          // There were no ticks within the candle's period yet.
+          CandleOCTOHLC<double> _empty;
+          _shift = rings[_ilevel].Insert(_itime, _empty);
+        }
+        if (_shift >= 0) {
+          rings[_ilevel].UpdateByShift(_shift, _timestamp, _price);
+        }
+      }
+      return;
+    }
+
+    CandleOCTOHLC<double> _completed = _ring.GetByShift(0);
+    CandleOCTOHLC<double> _candle(_price, _price, _price, _price, _timestamp, _timestamp);
+    _ring.Push(_candle_time, _candle);
+    if (_newest_time == -1) {
+      Seed(_level, _candle_time);
+    } else {
+      RollUp(_level, _completed, _candle_time);
+    }
+  }
+
+  /**
+   * Starts empty candles on levels fed by given level, unless they already have the candle.
+   */
+  void Seed(int _level, long _candle_time) {
+    for (int _child = 0; _child < ArraySize(parents); ++_child) {
+      if (parents[_child] == _level) {
+        long _child_time = CalcCandleTimestamp(_child, _candle_time);
+        if (rings[_child].GetNewestTime() == _child_time) {
+          continue;
+        }
+        CandleOCTOHLC<double> _empty;
+        rings[_child].Push(_child_time, _empty);
+        Seed(_child, _child_time);
+      }
+    }
+  }
+
+  /**
+   * Builds candles of a newly added level from completed candles of the level which feeds it.
+   */
+  void Build(int _level) {
+    int _parent = parents[_level];
+    if (_parent == -1 || rings[_parent].Size() == 0) {
+      // Level will be started by the next tick.
+      return;
+    }
+    BufferCandleRing<double>* _ring = rings[_level];
+    BufferCandleRing<double>* _parent_ring = rings[_parent];
+    // The newest candle of the parent is in progress, so it isn't rolled up.
+    for (int _shift = _parent_ring.Size() - 1; _shift >= 0; --_shift) {
+      long _time = CalcCandleTimestamp(_level, _parent_ring.GetTimeByShift(_shift));
+      if (_time != _ring.GetNewestTime()) {
+        CandleOCTOHLC<double> _empty;
+        _ring.Push(_time, _empty);
+      }
+      if (_shift > 0) {
+        CandleOCTOHLC<double> _completed = _parent_ring.GetByShift(_shift);
+        _ring.MergeByShift(0, _completed);
+      }
+    }
+  }
+
+  /**
+   * Rolls completed candle of a given level into levels fed by it.
+   *
+   * @param _candle_time
+   *   Open time of the candle which just started on the given level.
+   */
+  void RollUp(int _level, CandleOCTOHLC<double>& _completed, long _candle_time) {
+    for (int _child = 0; _child < ArraySize(parents); ++_child) {
+      if (parents[_child] != _level) {
+        continue;
+      }
+      BufferCandleRing<double>* _ring = rings[_child];
+      long _child_time = CalcCandleTimestamp(_child, _candle_time);
+
+      // Completed candle always belongs to the newest candle of the child level.
+      _ring.MergeByShift(0, _completed);
+
+      if (_child_time != _ring.GetNewestTime()) {
+        // Child's candle has been completed too, starting an empty one.
+        CandleOCTOHLC<double> _child_completed = _ring.GetByShift(0);
+        CandleOCTOHLC<double> _empty;
+        _ring.Push(_child_time, _empty);
+        RollUp(_child, _child_completed, _child_time);
+      }
+    }
+  }
+
+  /**
+   * Returns the next level (in the order of the feeding chain) which is fed by the given root level.
+   *
+   * Used to walk through all levels affected by a single tick. Returns -1 when there are no more levels.
+   */
+  int GetChildOrDescendant(int _root, int _current) {
+    // Levels are walked by increasing period, so it is enough to find the next level fed (directly or not) by root.
+    int _next = -1;
+    for (int i = 0; i < ArraySize(spcs); ++i) {
+      if (spcs[i] > spcs[_current] && GetRootLevel(i) == _root && (_next == -1 || spcs[i] < spcs[_next])) {
+        _next = i;
+      }
+    }
+    return _next;
+  }
+
+  /**
+   * Returns level fed by ticks which (directly or not) feeds given level.
+   */
+  int GetRootLevel(int _level) {
+    while (parents[_level] != -1) {
+      _level = parents[_level];
+    }
+    return _level;
+  }
+
+ public:
+  /* Special methods */
+
+  /**
+   * Class constructor.
+   *
+   * @param _capacity
+   *   Number of candles kept per timeframe.
+   */
+  IndicatorTfAggregator(int _capacity = 10000)
+      : capacity(_capacity), feeder_id(-1), last_subscriber_id(-1), num_ticks(0) {}
+
+  /**
+   * Class deconstructor.
+   */
+  ~IndicatorTfAggregator() {
+    for (int i = 0; i < ArraySize(rings); ++i) {
+      delete rings[i];
+    }
+  }
+
+  /* Getters */
+
+  /**
+   * Returns number of levels (distinct timeframes).
+   */
+  int GetLevelsCount() { return ArraySize(spcs); }
+
+  /**
+   * Returns number of processed ticks.
+   */
+  unsigned long GetTicksCount() { return num_ticks; }
+
+  /**
+   * Returns level for a given number of seconds per candle or -1 if not found.
+   */
+  int GetLevel(unsigned int _spc) {
+    for (int i = 0; i < ArraySize(spcs); ++i) {
+      if (spcs[i] == _spc) {
+        return i;
+      }
+    }
+    return -1;
+  }
+
+  /**
+   * Returns output ring of a given level.
+   *
+   * Note that the newest candle in the ring of coarser level doesn't include
+   * the in-progress candles of finer levels. Use GetCandle() to read it.
+   */
+  BufferCandleRing<double>* GetRing(int _level) { return rings[_level]; }
+
+  /**
+   * Returns seconds per candle of a given level.
+   */
+  unsigned int GetSecsPerCandle(int _level) { return spcs[_level]; }
+
+  /**
+   * Returns number of candles available on a given level.
+   */
+  int GetCandlesCount(int _level) { return rings[_level].Size(); }
+
+  /**
+   * Returns open time of the candle at given shift.
+   */
+  long GetCandleTime(int _level, int _shift) { return rings[_level].GetTimeByShift(_shift); }
+
+  /**
+   * Returns candle of a given level at given shift.
+   */
+  CandleOCTOHLC<double> GetCandle(int _level, int _shift) {
+    CandleOCTOHLC<double> _candle = rings[_level].GetByShift(_shift);
+    if (_shift == 0) {
+      // Merging in-progress candles from finer levels.
+      for (int _parent = parents[_level]; _parent != -1; _parent = parents[_parent]) {
+        CandleOCTOHLC<double> _live = rings[_parent].GetByShift(0);
+        _candle.Merge(_live);
+      }
+    }
+    return _candle;
+  }
+
+  /**
+   * Returns shift of the candle of a given level which covers given time.
+   */
+  int GetShiftByTime(int _level, long _time, bool _exact = false) {
+    return rings[_level].GetShiftByTime(CalcCandleTimestamp(_level, _time), _exact);
+  }
+
+  /* Setters */
+
+  /**
+   * Adds timeframe to aggregate.
+   *
+   * Candles of the new timeframe are built from the finer timeframe which feeds it, if there is any. Otherwise the
+   * new timeframe starts with the next tick. Candles of other timeframes are kept.
+   *
+   * @return
+   *   Returns level of the timeframe.
+   */
+  int AddTf(unsigned int _spc) {
+    int _level = GetLevel(_spc);
+    if (_level != -1) {
+      return _level;
+    }
+    _level = ArraySize(spcs);
+    ArrayResize(spcs, _level + 1);
+    ArrayResize(parents, _level + 1);
+    ArrayResize(rings, _level + 1);
+    spcs[_level] = _spc;
+    rings[_level] = new BufferCandleRing<double>(capacity);
+    UpdateParents();
+    Build(_level);
+    return _level;
+  }
+
+  /* Subscribers */
+
+  /**
+   * Registers new subscriber (e.g. IndicatorTf instance).
+   *
+   * @return
+   *   Returns identifier of the subscriber.
+   */
+  int Subscribe() { return ++last_subscriber_id; }
+
+  /**
+   * Unregisters subscriber. Another subscriber will take over feeding of ticks.
+   */
+  void Unsubscribe(int _subscriber_id) {
+    if (feeder_id == _subscriber_id) {
+      feeder_id = -1;
+    }
+  }
+
+  /**
+   * Checks whether given subscriber should feed ticks into aggregator.
+   *
+   * Many indicators share the same tick source, so only one of them feeds ticks.
+   */
+  bool IsFeeder(int _subscriber_id) {
+    if (feeder_id == -1) {
+      feeder_id = _subscriber_id;
+    }
+    return feeder_id == _subscriber_id;
+  }
+
+  /* Main methods */
+
+  /**
+   * Processes single tick.
+   */
+  void OnTick(long _timestamp, double _price) {
+    ++num_ticks;
+    for (int i = 0; i < ArraySize(parents); ++i) {
+      if (parents[i] == -1) {
+        UpdateLevel(i, _timestamp, _price);
+      }
+    }
+  }
+
+  /**
+   * Removes all aggregated candles.
+   */
+  void Clear() {
+    for (int i = 0; i < ArraySize(rings); ++i) {
+      rings[i].Clear();
+    }
+    num_ticks = 0;
+  }
+};
+
+#endif
@@ -63,8 +63,6 @@ class IndicatorTick : public Indicator<TS> {
     // We can only index via timestamp.
     flags |= INDI_FLAG_INDEXABLE_BY_TIMESTAMP;
 
-    itdata.AddFlags(DICT_FLAG_FILL_HOLES_UNSORTED);
-    itdata.SetOverflowListener(IndicatorTickOverflowListener, 10);
     // Ask and Bid price.
     Set<int>(STRUCT_ENUM(IndicatorDataParams, IDATA_PARAM_MAX_MODES), 2);
   }
@@ -122,8 +120,9 @@ class IndicatorTick : public Indicator<TS> {
    * Sends historic entries to listening indicators. May be overriden.
    */
   void EmitHistory() override {
-    for (DictStructIterator<long, TickAB<TV>> iter(itdata.Begin()); iter.IsValid(); ++iter) {
-      IndicatorDataEntry _entry = TickToEntry(iter.Key(), iter.Value());
+    for (int i = 0; i < itdata.GetSortedSize(); ++i) {
+      TickAB<TV> _tick = itdata.GetSortedTick(i);
+      IndicatorDataEntry _entry = TickToEntry(itdata.GetSortedTime(i), _tick);
       EmitEntry(_entry);
     }
   }
@@ -271,24 +270,6 @@ class IndicatorTick : public Indicator<TS> {
     }
     return _result;
   }
-
-  /* Callback methods */
-
-  /**
-   * Function should return true if resize can be made, or false to overwrite current slot.
-   */
-  static bool IndicatorTickOverflowListener(ENUM_DICT_OVERFLOW_REASON _reason, int _size, int _num_conflicts) {
-    switch (_reason) {
-      case DICT_OVERFLOW_REASON_FULL:
-        // We allow resize if dictionary size is less than 86400 slots.
-        return _size < 86400;
-      case DICT_OVERFLOW_REASON_TOO_MANY_CONFLICTS:
-      default:
-        // When there is too many conflicts, we just reject doing resize, so first conflicting slot will be reused.
-        break;
-    }
-    return false;
-  }
 };
 
 #endif
@@ -62,6 +62,8 @@ class IndicatorBase : public Chart {
   bool indicator_builtin;
   long last_tick_time;  // Time of the last Tick() call.
   int flags;            // Flags such as INDI_FLAG_INDEXABLE_BY_SHIFT.
+  long instance_id;     // Unique identifier of the instance.
+  static long last_instance_id;
 
  public:
   /* Indicator enumerations */
@@ -86,6 +88,7 @@ class IndicatorBase : public Chart {
     flags = INDI_FLAG_INDEXABLE_BY_SHIFT | INDI_FLAG_SOURCE_REQ_INDEXABLE_BY_SHIFT;
     calc_start_bar = 0;
     last_tick_time = 0;
+    instance_id = ++last_instance_id;
   }
 
   /**
@@ -96,6 +99,7 @@ class IndicatorBase : public Chart {
     flags = INDI_FLAG_INDEXABLE_BY_SHIFT | INDI_FLAG_SOURCE_REQ_INDEXABLE_BY_SHIFT;
     calc_start_bar = 0;
     last_tick_time = 0;
+    instance_id = ++last_instance_id;
   }
 
   /**
@@ -238,6 +242,11 @@ class IndicatorBase : public Chart {
    */
   virtual string GetFullName() { return GetName(); }
 
+  /**
+   * Gets unique identifier of the indicator instance (e.g. to be used in cache keys).
+   */
+  long GetInstanceId() { return instance_id; }
+
   /**
    * Get more descriptive name of the indicator.
    */
@@ -325,6 +334,11 @@ class IndicatorBase : public Chart {
    */
   string GetSymbol() { return Get<string>(CHART_PARAM_SYMBOL); }
 
+  /**
+   * Gets indicator's timeframe.
+   */
+  ENUM_TIMEFRAMES GetTf() { return Get<ENUM_TIMEFRAMES>(CHART_PARAM_TF); }
+
   /* Defines MQL backward compatible methods */
 
   double iCustom(int& _handle, string _symbol, ENUM_TIMEFRAMES _tf, string _name, int _mode, int _shift) {
@@ -457,3 +471,5 @@ class IndicatorBase : public Chart {
 #endif
   }
 };
+
+long IndicatorBase::last_instance_id = 0;
@@ -46,4 +46,10 @@ template <typename T>
 extern T MathLog10(T value1);
 template <typename T>
 extern T log10(T value);
+template <typename T>
+extern T MathLog(T value);
+template <typename T>
+extern T MathExp(T value);
+template <typename T>
+extern T MathSqrt(T value);
 #endif
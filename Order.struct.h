@@ -260,6 +260,9 @@ struct OrderData {
   string comment;                        // Comment.
   string ext_id;                         // External trading system identifier.
   string symbol;                         // Symbol of the order.
+  unsigned int revision;                 // Number of changes of the values.
+  static unsigned int revision_all;      // Number of changes of the values of all orders.
+
  public:
   OrderData()
       : magic(0),
@@ -288,7 +291,8 @@ struct OrderData {
         last_error(ERR_NO_ERROR),
         symbol(NULL),
         volume_curr(0),
-        volume_init(0) {}
+        volume_init(0),
+        revision(0) {}
   // Copy constructor.
   OrderData(OrderData &_odata) { this = _odata; }
   // Getters.
@@ -478,6 +482,7 @@ struct OrderData {
   // Setters.
   template <typename T>
   void Set(ENUM_ORDER_PROPERTY_CUSTOM _prop_name, T _value) {
+    Changed();
     switch (_prop_name) {
       case ORDER_PROP_COMMISSION:
         commission = (double)_value;
@@ -522,6 +527,7 @@ struct OrderData {
     SetUserError(ERR_INVALID_PARAMETER);
   }
   void Set(ENUM_ORDER_PROPERTY_DOUBLE _prop_name, double _value) {
+    Changed();
     switch (_prop_name) {
       case ORDER_VOLUME_CURRENT:
         volume_curr = _value;
@@ -549,6 +555,7 @@ struct OrderData {
     SetUserError(ERR_INVALID_PARAMETER);
   }
   void Set(ENUM_ORDER_PROPERTY_INTEGER _prop_name, long _value) {
+    Changed();
     switch (_prop_name) {
       case ORDER_TYPE:
         type = (ENUM_ORDER_TYPE)_value;
@@ -598,6 +605,7 @@ struct OrderData {
     SetUserError(ERR_INVALID_PARAMETER);
   }
   void Set(ENUM_ORDER_PROPERTY_STRING _prop_name, string _value) {
+    Changed();
     switch (_prop_name) {
       case ORDER_COMMENT:
         comment = _value;
@@ -626,6 +634,13 @@ struct OrderData {
     last_error = ERR_NO_ERROR;
   }
   void RefreshProfit() { profit = (price_current - price_open) * GetTypeValue(); }
+  // Revisions.
+  void Changed() {
+    ++revision;
+    ++revision_all;
+  }
+  unsigned int GetRevision() { return revision; }
+  static unsigned int GetRevisionAll() { return revision_all; }
   // Serializers.
   SerializerNodeType Serialize(Serializer &s) {
     s.Pass(THIS_REF, "magic", magic);
@@ -666,6 +681,8 @@ struct OrderData {
   }
 };
 
+unsigned int OrderData::revision_all = 0;
+
 // Structure for order static methods.
 struct OrderStatic {
   /**
@@ -683,6 +700,21 @@ struct OrderStatic {
 #endif
   }
 
+  /**
+   * Selects an active position by its ticket for further processing.
+   *
+   * @docs
+   * - https://docs.mql4.com/trading/orderselect
+   * - https://www.mql5.com/en/docs/trading/positionselectbyticket
+   */
+  static bool SelectByTicket(unsigned long _ticket) {
+#ifdef __MQL4__
+    return ::OrderSelect((int)_ticket, SELECT_BY_TICKET, MODE_TRADES) && ::OrderCloseTime() == 0;
+#else
+    return ::PositionSelectByTicket(_ticket);
+#endif
+  }
+
   /**
    * Returns expiration date of the selected pending order/position.
    *
@@ -788,6 +820,22 @@ struct OrderStatic {
 #endif
   }
 
+  /**
+   * Returns current price of the currently selected order/position.
+   *
+   * @docs
+   * - http://docs.mql4.com/trading/ordercloseprice
+   * - https://www.mql5.com/en/docs/trading/positiongetdouble
+   */
+  static double PriceCurrent() {
+#ifdef __MQL4__
+    // For open orders, close price is the current price.
+    return ::OrderClosePrice();
+#else
+    return ::PositionGetDouble(POSITION_PRICE_CURRENT);
+#endif
+  }
+
   /**
    * Returns profit of the currently selected order/position.
    *
@@ -957,6 +1005,30 @@ struct OrderStatic {
   }
 };
 
+/**
+ * Snapshot of values of an active order/position which change while it is open.
+ *
+ * Used to detect which orders have been changed without refreshing all of them.
+ */
+struct OrderSnapshot {
+  unsigned long ticket;  // Ticket number.
+  double price_current;  // Current price (profit changes with it).
+  double sl;             // Stop loss.
+  double tp;             // Take profit.
+  double volume;         // Current volume.
+  OrderSnapshot() : ticket(0), price_current(0), sl(0), tp(0), volume(0) {}
+  /**
+   * Loads values of the currently selected order/position.
+   */
+  void Load() {
+    ticket = OrderStatic::Ticket();
+    price_current = OrderStatic::PriceCurrent();
+    sl = OrderStatic::StopLoss();
+    tp = OrderStatic::TakeProfit();
+    volume = OrderStatic::Lots();
+  }
+};
+
 /**
  * Proxy class used to serialize MqlTradeRequest object.
  *
@@ -0,0 +1,640 @@
+//+------------------------------------------------------------------+
+//|                                                EA31337 framework |
+//|                                 Copyright 2016-2022, EA31337 Ltd |
+//|                                       https://github.com/EA31337 |
+//+------------------------------------------------------------------+
+
+/*
+ * This file is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file
+ * Implements aggregates of orders' values maintained incrementally.
+ */
+
+// Prevents processing this includes file for the second time.
+#ifndef ORDER_AGGREGATES_H
+#define ORDER_AGGREGATES_H
+
+// Includes.
+#include "Dict.mqh"
+#include "Order.mqh"
+#include "Refs.mqh"
+
+/**
+ * Base class for aggregates updated on order's add, removal and modification.
+ */
+class OrderAggregateBase : public Dynamic {
+ public:
+  /**
+   * Adds order into the aggregate.
+   */
+  virtual void Add(Order *_order) = 0;
+
+  /**
+   * Removes order from the aggregate.
+   */
+  virtual void Remove(Order *_order) = 0;
+
+  /**
+   * Updates order's values after they have been changed.
+   */
+  virtual void Update(Order *_order) = 0;
+
+  /**
+   * Removes all orders.
+   */
+  virtual void Clear() = 0;
+};
+
+/**
+ * Running sums and counts of an order's property grouped by another order's property.
+ *
+ * E.g. profit (ORDER_PROP_PROFIT) by order type (ORDER_TYPE) or volume (ORDER_VOLUME_CURRENT) by magic (ORDER_MAGIC).
+ */
+template <typename E, typename EG>
+class OrderAggregate : public OrderAggregateBase {
+ protected:
+  E prop;                        // Property to sum.
+  EG prop_group;                 // Property to group sums by.
+  bool is_grouped;               // Whether sums are grouped (otherwise there is a single group).
+  Dict<long, int> orders_index;  // Order's ticket to position in orders' arrays.
+  ARRAY(long, orders_tickets);   // Tickets of aggregated orders.
+  ARRAY(double, orders_values);  // Values of aggregated orders.
+  ARRAY(long, orders_groups);    // Groups of aggregated orders.
+  Dict<long, int> groups_index;  // Group's key to position in groups' arrays.
+  ARRAY(long, groups_keys);      // Keys of groups.
+  ARRAY(double, groups_sums);    // Sums of values per group.
+  ARRAY(int, groups_counts);     // Number of orders per group.
+  double total;                  // Sum of values of all orders.
+
+  /**
+   * Returns position of the given group. Creates group if it doesn't exist.
+   */
+  int GetGroupPos(long _key) {
+    int _pos = groups_index.GetByKey(_key, -1);
+    if (_pos == -1) {
+      _pos = ArraySize(groups_keys);
+      ArrayResize(groups_keys, _pos + 1);
+      ArrayResize(groups_sums, _pos + 1);
+      ArrayResize(groups_counts, _pos + 1);
+      groups_keys[_pos] = _key;
+      groups_sums[_pos] = 0;
+      groups_counts[_pos] = 0;
+      groups_index.Set(_key, _pos);
+    }
+    return _pos;
+  }
+
+  /**
+   * Adds value into the given group.
+   */
+  void AddToGroup(long _key, double _value, int _count) {
+    int _pos = GetGroupPos(_key);
+    groups_counts[_pos] += _count;
+    // Resetting the sum of an empty group, so rounding errors don't accumulate.
+    groups_sums[_pos] = groups_counts[_pos] > 0 ? groups_sums[_pos] + _value : 0;
+    total = Size() > 0 ? total + _value : 0;
+  }
+
+  /**
+   * Returns group's key of the given order.
+   */
+  long GetGroupKey(Order *_order) { return is_grouped ? _order.Get<long>(prop_group) : 0; }
+
+ public:
+  /**
+   * Class constructor.
+   */
+  OrderAggregate(E _prop, EG _prop_group, bool _is_grouped = true)
+      : prop(_prop), prop_group(_prop_group), is_grouped(_is_grouped), total(0) {}
+
+  /* Getters */
+
+  /**
+   * Returns property to sum.
+   */
+  E GetProp() { return prop; }
+
+  /**
+   * Returns property to group sums by.
+   */
+  EG GetGroupProp() { return prop_group; }
+
+  /**
+   * Checks whether sums are grouped.
+   */
+  bool IsGrouped() { return is_grouped; }
+
+  /**
+   * Returns number of aggregated orders.
+   */
+  int Size() { return ArraySize(orders_tickets); }
+
+  /**
+   * Returns sum of values of all orders.
+   */
+  double GetTotal() { return total; }
+
+  /**
+   * Returns sum of values of orders in the given group.
+   */
+  double GetSum(long _key) {
+    int _pos = groups_index.GetByKey(_key, -1);
+    return _pos != -1 ? groups_sums[_pos] : 0;
+  }
+
+  /**
+   * Returns number of orders in the given group.
+   */
+  int GetCount(long _key) {
+    int _pos = groups_index.GetByKey(_key, -1);
+    return _pos != -1 ? groups_counts[_pos] : 0;
+  }
+
+  /* OrderAggregateBase methods */
+
+  /**
+   * Adds order into the aggregate.
+   */
+  virtual void Add(Order *_order) {
+    long _ticket = _order.Get<long>(ORDER_PROP_TICKET);
+    if (orders_index.KeyExists(_ticket)) {
+      Update(_order);
+      return;
+    }
+    int _pos = Size();
+    ArrayResize(orders_tickets, _pos + 1, 100);
+    ArrayResize(orders_values, _pos + 1, 100);
+    ArrayResize(orders_groups, _pos + 1, 100);
+    orders_tickets[_pos] = _ticket;
+    orders_values[_pos] = _order.Get<double>(prop);
+    orders_groups[_pos] = GetGroupKey(_order);
+    orders_index.Set(_ticket, _pos);
+    AddToGroup(orders_groups[_pos], orders_values[_pos], 1);
+  }
+
+  /**
+   * Removes order from the aggregate.
+   */
+  virtual void Remove(Order *_order) {
+    long _ticket = _order.Get<long>(ORDER_PROP_TICKET);
+    int _pos = orders_index.GetByKey(_ticket, -1);
+    if (_pos == -1) {
+      return;
+    }
+    int _last = Size() - 1;
+    long _group = orders_groups[_pos];
+    double _value = orders_values[_pos];
+    // Moving the last order in place of the removed one.
+    orders_tickets[_pos] = orders_tickets[_last];
+    orders_values[_pos] = orders_values[_last];
+    orders_groups[_pos] = orders_groups[_last];
+    orders_index.Set(orders_tickets[_pos], _pos);
+    orders_index.Unset(_ticket);
+    ArrayResize(orders_tickets, _last, 100);
+    ArrayResize(orders_values, _last, 100);
+    ArrayResize(orders_groups, _last, 100);
+    AddToGroup(_group, -_value, -1);
+  }
+
+  /**
+   * Updates order's values after they have been changed.
+   */
+  virtual void Update(Order *_order) {
+    int _pos = orders_index.GetByKey(_order.Get<long>(ORDER_PROP_TICKET), -1);
+    if (_pos == -1) {
+      Add(_order);
+      return;
+    }
+    double _value = _order.Get<double>(prop);
+    long _group = GetGroupKey(_order);
+    if (_group != orders_groups[_pos]) {
+      AddToGroup(orders_groups[_pos], -orders_values[_pos], -1);
+      AddToGroup(_group, _value, 1);
+      orders_groups[_pos] = _group;
+    } else if (_value != orders_values[_pos]) {
+      AddToGroup(_group, _value - orders_values[_pos], 0);
+    }
+    orders_values[_pos] = _value;
+  }
+
+  /**
+   * Removes all orders.
+   */
+  virtual void Clear() {
+    orders_index.Clear();
+    groups_index.Clear();
+    ArrayResize(orders_tickets, 0);
+    ArrayResize(orders_values, 0);
+    ArrayResize(orders_groups, 0);
+    ArrayResize(groups_keys, 0);
+    ArrayResize(groups_sums, 0);
+    ArrayResize(groups_counts, 0);
+    total = 0;
+  }
+};
+
+/**
+ * Orders sorted by property's value, so orders with the lowest and the highest value are found in O(1).
+ *
+ * Each change of the value moves the order within the sorted array in O(n), so it's meant for properties which
+ * rarely change (e.g. open price or volume), not for the ones changing on every refresh (e.g. profit).
+ */
+template <typename E>
+class OrderSortedIndex : public OrderAggregateBase {
+ protected:
+  E prop;                          // Property to sort by.
+  Dict<long, double> orders_keys;  // Order's ticket to its indexed value.
+  ARRAY(Ref<Order>, orders);       // Orders sorted by value (ascending).
+  ARRAY(double, values);           // Sorted values.
+
+  /**
+   * Returns position of the first value which is not lesser than the given one.
+   */
+  int LowerBound(double _value) {
+    int _lo = 0, _hi = ArraySize(values);
+    while (_lo < _hi) {
+      int _mid = (_lo + _hi) / 2;
+      if (values[_mid] < _value) {
+        _lo = _mid + 1;
+      } else {
+        _hi = _mid;
+      }
+    }
+    return _lo;
+  }
+
+  /**
+   * Returns position of the order with the given ticket and indexed value or -1 if not found.
+   */
+  int Find(long _ticket, double _value) {
+    for (int i = LowerBound(_value); i < ArraySize(values) && values[i] == _value; i++) {
+      if (orders[i].Ptr().Get<long>(ORDER_PROP_TICKET) == _ticket) {
+        return i;
+      }
+    }
+    return -1;
+  }
+
+  /**
+   * Inserts order at the sorted position.
+   */
+  void Insert(Order *_order, double _value) {
+    int _size = ArraySize(values);
+    int _pos = LowerBound(_value);
+    ArrayResize(orders, _size + 1, 100);
+    ArrayResize(values, _size + 1, 100);
+    for (int i = _size; i > _pos; i--) {
+      orders[i] = orders[i - 1];
+      values[i] = values[i - 1];
+    }
+    orders[_pos] = _order;
+    values[_pos] = _value;
+    orders_keys.Set(_order.Get<long>(ORDER_PROP_TICKET), _value);
+  }
+
+  /**
+   * Removes order at the given position.
+   */
+  void RemoveAt(int _pos) {
+    int _size = ArraySize(values);
+    for (int i = _pos; i < _size - 1; i++) {
+      orders[i] = orders[i + 1];
+      values[i] = values[i + 1];
+    }
+    ArrayResize(orders, _size - 1, 100);
+    ArrayResize(values, _size - 1, 100);
+  }
+
+ public:
+  /**
+   * Class constructor.
+   */
+  OrderSortedIndex(E _prop) : prop(_prop) {}
+
+  /* Getters */
+
+  /**
+   * Returns property to sort by.
+   */
+  E GetProp() { return prop; }
+
+  /**
+   * Returns number of indexed orders.
+   */
+  int Size() { return ArraySize(orders); }
+
+  /**
+   * Returns order with the lowest value.
+   */
+  Ref<Order> GetMin() {
+    Ref<Order> _order;
+    if (Size() > 0) {
+      _order = orders[0];
+    }
+    return _order;
+  }
+
+  /**
+   * Returns order with the highest value.
+   */
+  Ref<Order> GetMax() {
+    Ref<Order> _order;
+    if (Size() > 0) {
+      _order = orders[Size() - 1];
+    }
+    return _order;
+  }
+
+  /* OrderAggregateBase methods */
+
+  /**
+   * Adds order into the index.
+   */
+  virtual void Add(Order *_order) {
+    if (orders_keys.KeyExists(_order.Get<long>(ORDER_PROP_TICKET))) {
+      Update(_order);
+      return;
+    }
+    Insert(_order, _order.Get<double>(prop));
+  }
+
+  /**
+   * Removes order from the index.
+   */
+  virtual void Remove(Order *_order) {
+    long _ticket = _order.Get<long>(ORDER_PROP_TICKET);
+    if (!orders_keys.KeyExists(_ticket)) {
+      return;
+    }
+    int _pos = Find(_ticket, orders_keys.GetByKey(_ticket));
+    if (_pos != -1) {
+      RemoveAt(_pos);
+    }
+    orders_keys.Unset(_ticket);
+  }
+
+  /**
+   * Moves order to the new sorted position after its value has been changed.
+   */
+  virtual void Update(Order *_order) {
+    long _ticket = _order.Get<long>(ORDER_PROP_TICKET);
+    double _value = _order.Get<double>(prop);
+    if (orders_keys.KeyExists(_ticket) && orders_keys.GetByKey(_ticket) == _value) {
+      return;
+    }
+    Remove(_order);
+    Insert(_order, _value);
+  }
+
+  /**
+   * Removes all orders.
+   */
+  virtual void Clear() {
+    orders_keys.Clear();
+    ArrayResize(orders, 0);
+    ArrayResize(values, 0);
+  }
+};
+
+/**
+ * Set of aggregates maintained for a container of orders.
+ *
+ * Owner of the container calls Add(), Remove() and Update() when orders are
+ * added, closed or modified, so OrderQuery can answer from the aggregates
+ * instead of iterating all orders. Orders changed elsewhere (e.g. by
+ * Order::Refresh()) are detected by their revisions and updated before the
+ * aggregates are read.
+ *
+ * Only values stored by orders can be aggregated. Values calculated on read
+ * (e.g. ORDER_PROP_PROFIT_VALUE, which depends on the current tick value)
+ * change without the order's revision and would go stale.
+ */
+class OrderAggregates : public Dynamic {
+ protected:
+  ARRAY(Ref<OrderAggregateBase>, aggregates);
+  Dict<long, int> orders_index;           // Order's ticket to position in orders' arrays.
+  ARRAY(Ref<Order>, orders);              // Aggregated orders.
+  ARRAY(unsigned int, orders_revisions);  // Revisions of aggregated orders' values.
+  unsigned int revision_all;              // Revision of all orders' values at the last sync.
+
+  /**
+   * Adds a new aggregate.
+   */
+  void AddAggregate(OrderAggregateBase *_aggregate) {
+    int _size = ArraySize(aggregates);
+    ArrayResize(aggregates, _size + 1);
+    aggregates[_size] = _aggregate;
+  }
+
+  /**
+   * Updates aggregates of orders which values have been changed since the last update.
+   *
+   * Costs nothing when none of the orders has been changed since the last sync.
+   */
+  void Sync() {
+    if (revision_all == OrderData::GetRevisionAll()) {
+      return;
+    }
+    for (int i = 0; i < ArraySize(orders); i++) {
+      if (orders[i].Ptr().GetRevision() != orders_revisions[i]) {
+        UpdateAggregates(orders[i].Ptr());
+        orders_revisions[i] = orders[i].Ptr().GetRevision();
+      }
+    }
+    revision_all = OrderData::GetRevisionAll();
+  }
+
+  /**
+   * Updates all aggregates with order's values.
+   */
+  void UpdateAggregates(Order *_order) {
+    for (int i = 0; i < ArraySize(aggregates); i++) {
+      aggregates[i].Ptr().Update(_order);
+    }
+  }
+
+ public:
+  /**
+   * Class constructor.
+   */
+  OrderAggregates() : revision_all(0) {}
+
+  /* Getters */
+
+  /**
+   * Returns running sums of a given property grouped by another property or NULL if they are not maintained.
+   */
+  template <typename E, typename EG>
+  OrderAggregate<E, EG> *GetSum(E _prop, EG _prop_group) {
+    Sync();
+    for (int i = 0; i < ArraySize(aggregates); i++) {
+      OrderAggregate<E, EG> *_aggregate = dynamic_cast<OrderAggregate<E, EG> *>(aggregates[i].Ptr());
+      if (_aggregate != NULL && _aggregate.IsGrouped() && _aggregate.GetProp() == _prop &&
+          _aggregate.GetGroupProp() == _prop_group) {
+        return _aggregate;
+      }
+    }
+    return NULL;
+  }
+
+  /**
+   * Returns running sum of a given property or NULL if it is not maintained.
+   */
+  template <typename E>
+  OrderAggregate<E, ENUM_ORDER_PROPERTY_CUSTOM> *GetSum(E _prop) {
+    Sync();
+    for (int i = 0; i < ArraySize(aggregates); i++) {
+      OrderAggregate<E, ENUM_ORDER_PROPERTY_CUSTOM> *_aggregate =
+          dynamic_cast<OrderAggregate<E, ENUM_ORDER_PROPERTY_CUSTOM> *>(aggregates[i].Ptr());
+      if (_aggregate != NULL && !_aggregate.IsGrouped() && _aggregate.GetProp() == _prop) {
+        return _aggregate;
+      }
+    }
+    return NULL;
+  }
+
+  /**
+   * Returns sorted index of a given property or NULL if it is not maintained.
+   */
+  template <typename E>
+  OrderSortedIndex<E> *GetIndex(E _prop) {
+    Sync();
+    for (int i = 0; i < ArraySize(aggregates); i++) {
+      OrderSortedIndex<E> *_index = dynamic_cast<OrderSortedIndex<E> *>(aggregates[i].Ptr());
+      if (_index != NULL && _index.GetProp() == _prop) {
+        return _index;
+      }
+    }
+    return NULL;
+  }
+
+  /* Setters */
+
+  /**
+   * Maintains running sums of a given property grouped by another property.
+   *
+   * Aggregates should be added before orders, as orders already added are not aggregated retroactively.
+   */
+  template <typename E, typename EG>
+  OrderAggregate<E, EG> *AddSum(E _prop, EG _prop_group) {
+    OrderAggregate<E, EG> *_aggregate = GetSum(_prop, _prop_group);
+    if (_aggregate == NULL) {
+      _aggregate = new OrderAggregate<E, EG>(_prop, _prop_group);
+      AddAggregate(_aggregate);
+    }
+    return _aggregate;
+  }
+
+  /**
+   * Maintains running sum of a given property.
+   */
+  template <typename E>
+  OrderAggregate<E, ENUM_ORDER_PROPERTY_CUSTOM> *AddSum(E _prop) {
+    OrderAggregate<E, ENUM_ORDER_PROPERTY_CUSTOM> *_aggregate = GetSum(_prop);
+    if (_aggregate == NULL) {
+      _aggregate = new OrderAggregate<E, ENUM_ORDER_PROPERTY_CUSTOM>(_prop, ORDER_PROP_NONE, false);
+      AddAggregate(_aggregate);
+    }
+    return _aggregate;
+  }
+
+  /**
+   * Maintains orders sorted by a given property.
+   *
+   * @see OrderSortedIndex
+   */
+  template <typename E>
+  OrderSortedIndex<E> *AddIndex(E _prop) {
+    OrderSortedIndex<E> *_index = GetIndex(_prop);
+    if (_index == NULL) {
+      _index = new OrderSortedIndex<E>(_prop);
+      AddAggregate(_index);
+    }
+    return _index;
+  }
+
+  /* Main methods */
+
+  /**
+   * Adds order into all aggregates.
+   */
+  void Add(Order *_order) {
+    long _ticket = _order.Get<long>(ORDER_PROP_TICKET);
+    if (orders_index.KeyExists(_ticket)) {
+      Update(_order);
+      return;
+    }
+    int _pos = ArraySize(orders);
+    ArrayResize(orders, _pos + 1, 100);
+    ArrayResize(orders_revisions, _pos + 1, 100);
+    orders[_pos] = _order;
+    orders_revisions[_pos] = _order.GetRevision();
+    orders_index.Set(_ticket, _pos);
+    for (int i = 0; i < ArraySize(aggregates); i++) {
+      aggregates[i].Ptr().Add(_order);
+    }
+  }
+
+  /**
+   * Removes order from all aggregates.
+   */
+  void Remove(Order *_order) {
+    long _ticket = _order.Get<long>(ORDER_PROP_TICKET);
+    int _pos = orders_index.GetByKey(_ticket, -1);
+    if (_pos != -1) {
+      // Moving the last order in place of the removed one.
+      int _last = ArraySize(orders) - 1;
+      orders[_pos] = orders[_last];
+      orders_revisions[_pos] = orders_revisions[_last];
+      orders_index.Set(orders[_pos].Ptr().Get<long>(ORDER_PROP_TICKET), _pos);
+      orders_index.Unset(_ticket);
+      ArrayResize(orders, _last, 100);
+      ArrayResize(orders_revisions, _last, 100);
+    }
+    for (int i = 0; i < ArraySize(aggregates); i++) {
+      aggregates[i].Ptr().Remove(_order);
+    }
+  }
+
+  /**
+   * Updates all aggregates after order's values have been changed.
+   */
+  void Update(Order *_order) {
+    int _pos = orders_index.GetByKey(_order.Get<long>(ORDER_PROP_TICKET), -1);
+    if (_pos == -1) {
+      Add(_order);
+      return;
+    }
+    orders_revisions[_pos] = _order.GetRevision();
+    UpdateAggregates(_order);
+  }
+
+  /**
+   * Removes all orders from aggregates.
+   */
+  void Clear() {
+    orders_index.Clear();
+    ArrayResize(orders, 0);
+    ArrayResize(orders_revisions, 0);
+    for (int i = 0; i < ArraySize(aggregates); i++) {
+      aggregates[i].Ptr().Clear();
+    }
+  }
+};
+
+#endif  // ORDER_AGGREGATES_H
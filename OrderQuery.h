@@ -28,12 +28,14 @@
 // Includes.
 #include "DictStruct.mqh"
 #include "Order.mqh"
+#include "OrderAggregates.h"
 #include "Refs.mqh"
 #include "Std.h"
 
 class OrderQuery : public Dynamic {
  protected:
   DictStruct<long, Ref<Order>> *orders;
+  OrderAggregates *aggregates;  // Aggregates maintained for orders (optional).
 
  public:
   // Enumeration of comparison operators.
@@ -47,12 +49,15 @@ class OrderQuery : public Dynamic {
     FINAL_ORDER_QUERY_OP,
   };
 
-  OrderQuery() {}
-  OrderQuery(DictStruct<long, Ref<Order>> &_orders) : orders(GetPointer(_orders)) {}
+  OrderQuery() : aggregates(NULL) {}
+  OrderQuery(DictStruct<long, Ref<Order>> &_orders, OrderAggregates *_aggregates = NULL)
+      : orders(GetPointer(_orders)), aggregates(_aggregates) {}
 
   /**
    * Calculates sum of order's value based on the property's enum.
    *
+   * Served from the running sum when it is maintained by aggregates.
+   *
    * @param
    *   _prop Order's property to sum by (e.g. ORDER_PROP_PROFIT).
    *
@@ -61,6 +66,12 @@ class OrderQuery : public Dynamic {
    */
   template <typename E, typename T>
   T CalcSumByProp(E _prop) {
+    if (aggregates != NULL) {
+      OrderAggregate<E, ENUM_ORDER_PROPERTY_CUSTOM> *_aggregate = aggregates.GetSum(_prop);
+      if (_aggregate != NULL) {
+        return (T)_aggregate.GetTotal();
+      }
+    }
     T _sum = 0;
     for (DictStructIterator<long, Ref<Order>> iter = orders.Begin(); iter.IsValid(); ++iter) {
       _sum += iter.Value().Ptr().Get<T>(_prop);
@@ -71,11 +82,19 @@ class OrderQuery : public Dynamic {
   /**
    * Calculates sum of order's value based on the property's enum with condition.
    *
+   * Served from the grouped running sums when they are maintained by aggregates.
+   *
    * @return
    *   Returns sum of order's values based on the condition.
    */
   template <typename E, typename ECT, typename ECV, typename T>
   T CalcSumByPropWithCond(E _prop, ECT _prop_cond_type, ECV _prop_cond_value) {
+    if (aggregates != NULL) {
+      OrderAggregate<E, ECT> *_aggregate = aggregates.GetSum(_prop, _prop_cond_type);
+      if (_aggregate != NULL) {
+        return (T)_aggregate.GetSum((long)_prop_cond_value);
+      }
+    }
     T _sum = 0;
     for (DictStructIterator<long, Ref<Order>> iter = orders.Begin(); iter.IsValid(); ++iter) {
       Order *_order = iter.Value().Ptr();
@@ -89,6 +108,8 @@ class OrderQuery : public Dynamic {
   /**
    * Find order by comparing property's value given the comparison operator.
    *
+   * Orders with the lowest or the highest value are served from the sorted index when it is maintained by aggregates.
+   *
    * @return
    *   Returns structure with reference to Order instance which has been found.
    *   On error, returns Ref<Order> pointing to NULL.
@@ -99,6 +120,12 @@ class OrderQuery : public Dynamic {
     if (orders.Size() == 0) {
       return _order_ref_found;
     }
+    if (aggregates != NULL && _op != ORDER_QUERY_OP_NA && _op != ORDER_QUERY_OP_EQ) {
+      OrderSortedIndex<E> *_index = aggregates.GetIndex(_prop);
+      if (_index != NULL && _index.Size() == orders.Size()) {
+        return _op == ORDER_QUERY_OP_GT || _op == ORDER_QUERY_OP_GE ? _index.GetMax() : _index.GetMin();
+      }
+    }
     _order_ref_found = orders.Begin().Value();
     for (DictStructIterator<long, Ref<Order>> iter = orders.Begin(); iter.IsValid(); ++iter) {
       Ref<Order> _order_ref = iter.Value();
@@ -147,11 +174,14 @@ class OrderQuery : public Dynamic {
   template <typename EP, typename ES, typename ECT, typename T>
   EP FindPropBySum(ARRAY_REF(EP, _props), ES _prop_sum, ECT _prop_sum_type,
                    STRUCT_ENUM(OrderQuery, ORDER_QUERY_OP) _op = STRUCT_ENUM(OrderQuery, ORDER_QUERY_OP_GT)) {
+    // Grouped running sums are looked up once for all properties.
+    OrderAggregate<ES, ECT> *_aggregate = aggregates != NULL ? aggregates.GetSum(_prop_sum, _prop_sum_type) : NULL;
     EP _peak_type = _props[0];
-    T _peak_sum = CalcSumByPropWithCond<ES, ECT, EP, T>(_prop_sum, _prop_sum_type, _peak_type);
-    for (int _i = 1; _i < ArraySize(_props); _i++) {
-      T _sum = CalcSumByPropWithCond<ES, ECT, EP, T>(_prop_sum, _prop_sum_type, _props[_i]);
-      if (Compare(_sum, _op, _peak_sum)) {
+    T _peak_sum = 0;
+    for (int _i = 0; _i < ArraySize(_props); _i++) {
+      T _sum = _aggregate != NULL ? (T)_aggregate.GetSum((long)_props[_i])
+                                  : CalcSumByPropWithCond<ES, ECT, EP, T>(_prop_sum, _prop_sum_type, _props[_i]);
+      if (_i == 0 || Compare(_sum, _op, _peak_sum)) {
         _peak_sum = _sum;
         _peak_type = _props[_i];
       }
@@ -192,5 +222,7 @@ class OrderQuery : public Dynamic {
    * @return
    *   Returns a pointer to the new instance.
    */
-  static OrderQuery *GetInstance(DictStruct<long, Ref<Order>> &_orders) { return new OrderQuery(_orders); }
+  static OrderQuery *GetInstance(DictStruct<long, Ref<Order>> &_orders, OrderAggregates *_aggregates = NULL) {
+    return new OrderQuery(_orders, _aggregates);
+  }
 };
@@ -0,0 +1,57 @@
+//+------------------------------------------------------------------+
+//|                                                EA31337 framework |
+//|                                 Copyright 2016-2022, EA31337 Ltd |
+//|                                       https://github.com/EA31337 |
+//+------------------------------------------------------------------+
+
+/*
+ * This file is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file
+ * Includes Redis's enums.
+ */
+
+#ifndef __MQL__
+// Allows the preprocessor to include a header file when it is needed.
+#pragma once
+#endif
+
+// Type of the value returned by Redis (RESP2 and RESP3).
+enum ENUM_REDIS_REPLY_TYPE {
+  REDIS_REPLY_TYPE_NONE = 0,          // No reply.
+  REDIS_REPLY_TYPE_STATUS = '+',      // Simple string.
+  REDIS_REPLY_TYPE_ERROR = '-',       // Simple error.
+  REDIS_REPLY_TYPE_INTEGER = ':',     // Integer.
+  REDIS_REPLY_TYPE_STRING = '$',      // Bulk string.
+  REDIS_REPLY_TYPE_ARRAY = '*',       // Array.
+  REDIS_REPLY_TYPE_NIL = '_',         // Null (also null bulk string and null array).
+  REDIS_REPLY_TYPE_DOUBLE = ',',      // Double (RESP3).
+  REDIS_REPLY_TYPE_BOOL = '#',        // Boolean (RESP3).
+  REDIS_REPLY_TYPE_BLOB_ERROR = '!',  // Bulk error (RESP3).
+  REDIS_REPLY_TYPE_VERBATIM = '=',    // Verbatim string (RESP3).
+  REDIS_REPLY_TYPE_BIGNUM = '(',      // Big number (RESP3).
+  REDIS_REPLY_TYPE_MAP = '%',         // Map, items are key-value pairs (RESP3).
+  REDIS_REPLY_TYPE_SET = '~',         // Set (RESP3).
+  REDIS_REPLY_TYPE_PUSH = '>',        // Out-of-band push data (RESP3).
+};
+
+// Result of parsing the received data.
+enum ENUM_REDIS_PARSE_RESULT {
+  REDIS_PARSE_RESULT_INCOMPLETE = 0,  // Not enough data received yet.
+  REDIS_PARSE_RESULT_OK,              // Single reply parsed.
+  REDIS_PARSE_RESULT_ERROR,           // Protocol error.
+};
@@ -0,0 +1,467 @@
+//+------------------------------------------------------------------+
+//|                                                EA31337 framework |
+//|                                 Copyright 2016-2022, EA31337 Ltd |
+//|                                       https://github.com/EA31337 |
+//+------------------------------------------------------------------+
+
+/*
+ * This file is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file
+ * Implements in-process fake Redis server.
+ */
+
+#ifndef __MQL__
+// Allows the preprocessor to include a header file when it is needed.
+#pragma once
+#endif
+
+// Includes.
+#include "Dict.mqh"
+#include "Redis.parser.h"
+#include "SerializerConversions.h"
+
+/**
+ * In-process fake Redis server.
+ *
+ * Understands RESP and inline commands and replies in RESP2, so the whole
+ * client stack (encoding, pipelining, parsing) can be tested and benchmarked
+ * offline. Supports a subset of commands: PING, ECHO, SET, GET, DEL, EXISTS,
+ * INCR, DECR, INCRBY, DECRBY, INCRBYFLOAT, PUBLISH, SUBSCRIBE, UNSUBSCRIBE,
+ * MULTI, EXEC and DISCARD.
+ */
+class RedisFakeServer {
+ protected:
+  // Parser of the received commands.
+  RedisReplyParser input;
+
+  // Parsed command's values.
+  RedisReply command[];
+
+  // Command's arguments.
+  string args[];
+
+  // Encoded replies.
+  unsigned char output[];
+
+  // Number of used bytes in the output buffer.
+  int output_size;
+
+  // Stored values.
+  Dict<string, string> values;
+
+  // Expiration times (in terms of GetTickCount()) of stored values.
+  Dict<string, long> expirations;
+
+  // Subscribed channels.
+  Dict<string, bool> subscriptions;
+
+  // Messages published on subscribed channels.
+  string messages[];
+
+  // Whether transaction has been started by MULTI.
+  bool in_multi;
+
+  // Arguments of commands queued by MULTI.
+  string multi_args[];
+
+  // Number of arguments of each command queued by MULTI.
+  int multi_num_args[];
+
+  /* Output */
+
+  /**
+   * Appends text into the output.
+   */
+  void Write(const string _text) {
+    unsigned char _data[];
+    int _length = StringToCharArray(_text, _data, 0, WHOLE_ARRAY, CP_UTF8) - 1;
+    if (output_size + _length > ArraySize(output)) {
+      int _size = ArraySize(output) * 2;
+      ArrayResize(output, _size > output_size + _length ? _size : output_size + _length);
+    }
+    if (_length > 0) {
+      ArrayCopy(output, _data, output_size, 0, _length);
+      output_size += _length;
+    }
+  }
+
+  void WriteStatus(const string _status) { Write("+" + _status + "\r\n"); }
+
+  void WriteError(const string _error) { Write("-" + _error + "\r\n"); }
+
+  void WriteInteger(long _value) { Write(":" + IntegerToString(_value) + "\r\n"); }
+
+  void WriteNil() { Write("$-1\r\n"); }
+
+  /**
+   * Encodes value as a bulk string. Length is a number of bytes in UTF-8.
+   */
+  string EncodeBulk(const string _value) {
+    unsigned char _data[];
+    int _length = StringToCharArray(_value, _data, 0, WHOLE_ARRAY, CP_UTF8) - 1;
+    return "$" + IntegerToString(_length) + "\r\n" + _value + "\r\n";
+  }
+
+  void WriteBulk(const string _value) { Write(EncodeBulk(_value)); }
+
+  void WriteArrayHeader(int _num_items) { Write("*" + IntegerToString(_num_items) + "\r\n"); }
+
+  /* Storage */
+
+  /**
+   * Checks whether key exists and hasn't expired. Expired key is removed.
+   */
+  bool KeyExists(const string _key) {
+    if (!values.KeyExists(_key)) {
+      return false;
+    }
+    if (expirations.KeyExists(_key) && (long)GetTickCount() >= expirations.GetByKey(_key)) {
+      values.Unset(_key);
+      expirations.Unset(_key);
+      return false;
+    }
+    return true;
+  }
+
+  /**
+   * Removes key. Returns whether key existed.
+   */
+  bool Remove(const string _key) {
+    bool _existed = KeyExists(_key);
+    values.Unset(_key);
+    expirations.Unset(_key);
+    return _existed;
+  }
+
+  /**
+   * Checks whether string contains a valid integer.
+   */
+  bool IsInteger(const string _value) {
+    int _length = StringLen(_value);
+    for (int i = 0; i < _length; ++i) {
+      unsigned short _char = StringGetCharacter(_value, i);
+      if ((_char < '0' || _char > '9') && !(i == 0 && _char == '-' && _length > 1)) {
+        return false;
+      }
+    }
+    return _length > 0;
+  }
+
+  /* Commands */
+
+  /**
+   * Splits inline command into arguments. Arguments may be enclosed in double quotes.
+   */
+  int SplitInline(const string _line, string& _args[]) {
+    int _num_args = 0;
+    int _length = StringLen(_line);
+    int i = 0;
+    while (i < _length) {
+      while (i < _length && StringGetCharacter(_line, i) == ' ') {
+        ++i;
+      }
+      if (i >= _length) {
+        break;
+      }
+      int _start = i;
+      string _arg;
+      if (StringGetCharacter(_line, i) == '"') {
+        // Quoted argument, skipping escaped characters.
+        for (++i; i < _length && StringGetCharacter(_line, i) != '"'; ++i) {
+          if (StringGetCharacter(_line, i) == '\\') {
+            ++i;
+          }
+        }
+        _arg = SerializerConversions::UnescapeString(StringSubstr(_line, _start + 1, i - _start - 1));
+        ++i;
+      } else {
+        while (i < _length && StringGetCharacter(_line, i) != ' ') {
+          ++i;
+        }
+        _arg = StringSubstr(_line, _start, i - _start);
+      }
+      if (_num_args >= ArraySize(_args)) {
+        ArrayResize(_args, _num_args + 1, 8);
+      }
+      _args[_num_args++] = _arg;
+    }
+    return _num_args;
+  }
+
+  /**
+   * Increments value by given amount and writes the reply.
+   */
+  void IncrementBy(const string _key, const string _amount, bool _float, bool _negate) {
+    string _value = KeyExists(_key) ? values.GetByKey(_key) : "0";
+    if (_float) {
+      double _result = StringToDouble(_value) + StringToDouble(_amount);
+      values.Set(_key, DoubleToString(_result));
+      WriteBulk(values.GetByKey(_key));
+      return;
+    }
+    if (!IsInteger(_value) || !IsInteger(_amount)) {
+      WriteError("ERR value is not an integer or out of range");
+      return;
+    }
+    long _result = StringToInteger(_value) + (_negate ? -1 : 1) * StringToInteger(_amount);
+    values.Set(_key, IntegerToString(_result));
+    WriteInteger(_result);
+  }
+
+  /**
+   * Executes a single command with given arguments and writes its reply.
+   */
+  void Execute(const string& _args[], int _offset, int _num_args) {
+    string _name = _args[_offset];
+    StringToUpper(_name);
+    int _num_params = _num_args - 1;
+    int i;
+
+    if (in_multi && _name != "EXEC" && _name != "DISCARD" && _name != "MULTI") {
+      // Queuing command until EXEC.
+      int _size = ArraySize(multi_args);
+      ArrayResize(multi_args, _size + _num_args, 64);
+      for (i = 0; i < _num_args; ++i) {
+        multi_args[_size + i] = _args[_offset + i];
+      }
+      ArrayResize(multi_num_args, ArraySize(multi_num_args) + 1, 16);
+      multi_num_args[ArraySize(multi_num_args) - 1] = _num_args;
+      WriteStatus("QUEUED");
+      return;
+    }
+
+    if (_name == "PING") {
+      if (_num_params > 0) {
+        WriteBulk(_args[_offset + 1]);
+      } else {
+        WriteStatus("PONG");
+      }
+    } else if (_name == "ECHO" && _num_params == 1) {
+      WriteBulk(_args[_offset + 1]);
+    } else if (_name == "SET" && _num_params >= 2) {
+      string _key = _args[_offset + 1];
+      long _expiration_ms = 0;
+      bool _nx = false, _xx = false;
+      for (i = 3; i < _num_args; ++i) {
+        string _option = _args[_offset + i];
+        StringToUpper(_option);
+        if (_option == "NX") {
+          _nx = true;
+        } else if (_option == "XX") {
+          _xx = true;
+        } else if ((_option == "PX" || _option == "EX") && i + 1 < _num_args) {
+          _expiration_ms = StringToInteger(_args[_offset + ++i]) * (_option == "EX" ? 1000 : 1);
+        } else {
+          WriteError("ERR syntax error");
+          return;
+        }
+      }
+      bool _exists = KeyExists(_key);
+      if ((_nx && _exists) || (_xx && !_exists)) {
+        WriteNil();
+        return;
+      }
+      values.Set(_key, _args[_offset + 2]);
+      if (_expiration_ms > 0) {
+        expirations.Set(_key, (long)GetTickCount() + _expiration_ms);
+      } else {
+        expirations.Unset(_key);
+      }
+      WriteStatus("OK");
+    } else if (_name == "GET" && _num_params == 1) {
+      if (KeyExists(_args[_offset + 1])) {
+        WriteBulk(values.GetByKey(_args[_offset + 1]));
+      } else {
+        WriteNil();
+      }
+    } else if ((_name == "DEL" || _name == "EXISTS") && _num_params >= 1) {
+      int _num_keys = 0;
+      for (i = 1; i < _num_args; ++i) {
+        _num_keys += (_name == "DEL" ? Remove(_args[_offset + i]) : KeyExists(_args[_offset + i])) ? 1 : 0;
+      }
+      WriteInteger(_num_keys);
+    } else if ((_name == "INCR" || _name == "DECR") && _num_params == 1) {
+      IncrementBy(_args[_offset + 1], "1", false, _name == "DECR");
+    } else if ((_name == "INCRBY" || _name == "DECRBY") && _num_params == 2) {
+      IncrementBy(_args[_offset + 1], _args[_offset + 2], false, _name == "DECRBY");
+    } else if (_name == "INCRBYFLOAT" && _num_params == 2) {
+      IncrementBy(_args[_offset + 1], _args[_offset + 2], true, false);
+    } else if (_name == "PUBLISH" && _num_params == 2) {
+      string _channel = _args[_offset + 1];
+      if (subscriptions.KeyExists(_channel)) {
+        // Message is received by the only client.
+        ArrayResize(messages, ArraySize(messages) + 1, 16);
+        messages[ArraySize(messages) - 1] =
+            "*3\r\n" + EncodeBulk("message") + EncodeBulk(_channel) + EncodeBulk(_args[_offset + 2]);
+        WriteInteger(1);
+      } else {
+        WriteInteger(0);
+      }
+    } else if ((_name == "SUBSCRIBE" || _name == "UNSUBSCRIBE") && _num_params >= 1) {
+      for (i = 1; i < _num_args; ++i) {
+        if (_name == "SUBSCRIBE") {
+          subscriptions.Set(_args[_offset + i], true);
+        } else {
+          subscriptions.Unset(_args[_offset + i]);
+        }
+        WriteArrayHeader(3);
+        WriteBulk(_name == "SUBSCRIBE" ? "subscribe" : "unsubscribe");
+        WriteBulk(_args[_offset + i]);
+        // Number of channels the client is subscribed to.
+        WriteInteger(subscriptions.Size());
+      }
+    } else if (_name == "MULTI") {
+      if (in_multi) {
+        WriteError("ERR MULTI calls can not be nested");
+        return;
+      }
+      in_multi = true;
+      WriteStatus("OK");
+    } else if (_name == "EXEC" || _name == "DISCARD") {
+      if (!in_multi) {
+        WriteError("ERR " + _name + " without MULTI");
+        return;
+      }
+      in_multi = false;
+      if (_name == "EXEC") {
+        WriteArrayHeader(ArraySize(multi_num_args));
+        int _pos = 0;
+        for (i = 0; i < ArraySize(multi_num_args); ++i) {
+          Execute(multi_args, _pos, multi_num_args[i]);
+          _pos += multi_num_args[i];
+        }
+      } else {
+        WriteStatus("OK");
+      }
+      ArrayResize(multi_args, 0, 64);
+      ArrayResize(multi_num_args, 0, 16);
+    } else {
+      WriteError("ERR unknown command or wrong number of arguments for '" + _args[_offset] + "'");
+    }
+  }
+
+ public:
+  /**
+   * Constructor.
+   */
+  RedisFakeServer() : output_size(0), in_multi(false) { ArrayResize(output, 4096); }
+
+  /**
+   * Receives bytes sent by the client and executes all completely received commands.
+   */
+  void Receive(const unsigned char& _data[], int _length) {
+    input.Feed(_data, _length);
+    Process();
+  }
+
+  /**
+   * Receives text sent by the client and executes all completely received commands.
+   */
+  void Receive(const string _text) {
+    input.Feed(_text);
+    Process();
+  }
+
+  /**
+   * Executes all completely received commands.
+   */
+  void Process() {
+    string _line;
+    while (input.GetPendingBytes() > 0) {
+      int _num_args = 0;
+      if (input.PeekByte() == REDIS_REPLY_TYPE_ARRAY) {
+        // RESP command, i.e., array of bulk strings.
+        int _count = 0;
+        ENUM_REDIS_PARSE_RESULT _result = input.Parse(command, _count);
+        if (_result == REDIS_PARSE_RESULT_INCOMPLETE) {
+          return;
+        }
+        if (_result == REDIS_PARSE_RESULT_ERROR || command[0].type != REDIS_REPLY_TYPE_ARRAY) {
+          WriteError("ERR Protocol error");
+          return;
+        }
+        _num_args = _count - 1;
+        if (ArraySize(args) < _num_args) {
+          ArrayResize(args, _num_args, 8);
+        }
+        for (int i = 0; i < _num_args; ++i) {
+          args[i] = command[i + 1].str;
+        }
+      } else {
+        // Inline command.
+        if (!input.ReadLine(_line)) {
+          return;
+        }
+        _num_args = SplitInline(_line, args);
+      }
+      if (_num_args > 0) {
+        Execute(args, 0, _num_args);
+      }
+    }
+  }
+
+  /**
+   * Moves all pending replies into the client's parser.
+   *
+   * @return
+   *   Returns false if there were no pending replies.
+   */
+  bool Flush(RedisReplyParser& _client) {
+    if (output_size == 0) {
+      return false;
+    }
+    _client.Feed(output, output_size);
+    output_size = 0;
+    return true;
+  }
+
+  /**
+   * Checks whether there are messages published on subscribed channels.
+   */
+  bool HasMessages() { return ArraySize(messages) > 0; }
+
+  /**
+   * Pops out the oldest published message (encoded in RESP).
+   */
+  string PopMessage() {
+    string _message = messages[0];
+    for (int i = 1; i < ArraySize(messages); ++i) {
+      messages[i - 1] = messages[i];
+    }
+    ArrayResize(messages, ArraySize(messages) - 1, 16);
+    return _message;
+  }
+
+  /**
+   * Checks whether channel has been subscribed.
+   */
+  bool Subscribed(const string _channel) { return subscriptions.KeyExists(_channel); }
+
+  /**
+   * Removes all stored values, subscriptions and pending data.
+   */
+  void Clear() {
+    values.Clear();
+    expirations.Clear();
+    subscriptions.Clear();
+    ArrayResize(messages, 0);
+    input.Clear();
+    output_size = 0;
+    in_multi = false;
+  }
+};
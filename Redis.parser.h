@@ -0,0 +1,326 @@
+//+------------------------------------------------------------------+
+//|                                                EA31337 framework |
+//|                                 Copyright 2016-2022, EA31337 Ltd |
+//|                                       https://github.com/EA31337 |
+//+------------------------------------------------------------------+
+
+/*
+ * This file is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file
+ * Implements incremental parser of Redis replies (RESP2 and RESP3).
+ */
+
+#ifndef __MQL__
+// Allows the preprocessor to include a header file when it is needed.
+#pragma once
+#endif
+
+// Includes.
+#include "Redis.struct.h"
+
+// Defines.
+#define REDIS_PARSER_INCOMPLETE -1
+#define REDIS_PARSER_ERROR -2
+
+/**
+ * Incremental parser of Redis replies.
+ *
+ * Received bytes are appended into the reusable buffer by Feed(). Parse()
+ * consumes a single reply only when it has been completely received, so data
+ * may arrive in chunks of any size.
+ */
+class RedisReplyParser {
+ protected:
+  // Received bytes.
+  unsigned char buffer[];
+
+  // Position of the first unparsed byte.
+  int start;
+
+  // Position after the last received byte.
+  int end;
+
+  /**
+   * Ensures there is a space for the given number of bytes to be appended.
+   */
+  void Reserve(int _length) {
+    if (start > 0 && (start == end || end + _length > ArraySize(buffer))) {
+      // Moving unparsed bytes to the beginning of the buffer.
+      if (start != end) {
+        ArrayCopy(buffer, buffer, 0, start, end - start);
+      }
+      end -= start;
+      start = 0;
+    }
+    if (end + _length > ArraySize(buffer)) {
+      int _size = ArraySize(buffer) * 2;
+      ArrayResize(buffer, _size > end + _length ? _size : end + _length);
+    }
+  }
+
+  /**
+   * Returns position of the "\r\n" sequence or REDIS_PARSER_INCOMPLETE if it hasn't been received yet.
+   */
+  int FindLineEnd(int _pos) {
+    for (int i = _pos; i < end - 1; ++i) {
+      if (buffer[i] == '\r' && buffer[i + 1] == '\n') {
+        return i;
+      }
+    }
+    return REDIS_PARSER_INCOMPLETE;
+  }
+
+  /**
+   * Parses integer stored between given positions.
+   */
+  long ParseInteger(int _from, int _to) {
+    long _result = 0;
+    bool _negative = false;
+    if (_from < _to && (buffer[_from] == '-' || buffer[_from] == '+')) {
+      _negative = buffer[_from] == '-';
+      ++_from;
+    }
+    for (int i = _from; i < _to; ++i) {
+      _result = _result * 10 + (buffer[i] - '0');
+    }
+    return _negative ? -_result : _result;
+  }
+
+  /**
+   * Returns string stored between given positions.
+   */
+  string ParseString(int _from, int _to) {
+    return _to > _from ? CharArrayToString(buffer, _from, _to - _from, CP_UTF8) : "";
+  }
+
+  /**
+   * Appends a new value into the output array.
+   */
+  int AddReply(RedisReply& _out[], int& _count, ENUM_REDIS_REPLY_TYPE _type) {
+    if (_count >= ArraySize(_out)) {
+      ArrayResize(_out, _count + 1, 64);
+    }
+    _out[_count].type = _type;
+    _out[_count].str = "";
+    _out[_count].integer = 0;
+    _out[_count].number = 0;
+    _out[_count].num_items = 0;
+    _out[_count].next = _count + 1;
+    return _count++;
+  }
+
+  /**
+   * Parses a single value (with its items) starting at given position.
+   *
+   * @return
+   *   Returns position after the value, REDIS_PARSER_INCOMPLETE or REDIS_PARSER_ERROR.
+   */
+  int ParseValue(int _pos, RedisReply& _out[], int& _count) {
+    if (_pos >= end) {
+      return REDIS_PARSER_INCOMPLETE;
+    }
+
+    unsigned char _type = buffer[_pos];
+    int _line_end = FindLineEnd(_pos + 1);
+
+    if (_line_end == REDIS_PARSER_INCOMPLETE) {
+      return REDIS_PARSER_INCOMPLETE;
+    }
+
+    int _next = _line_end + 2;
+    int _index;
+    long _length;
+
+    switch (_type) {
+      case REDIS_REPLY_TYPE_STATUS:
+      case REDIS_REPLY_TYPE_ERROR:
+      case REDIS_REPLY_TYPE_BIGNUM:
+        _index = AddReply(_out, _count, (ENUM_REDIS_REPLY_TYPE)_type);
+        _out[_index].str = ParseString(_pos + 1, _line_end);
+        return _next;
+
+      case REDIS_REPLY_TYPE_INTEGER:
+        _index = AddReply(_out, _count, REDIS_REPLY_TYPE_INTEGER);
+        _out[_index].integer = ParseInteger(_pos + 1, _line_end);
+        return _next;
+
+      case REDIS_REPLY_TYPE_DOUBLE:
+        _index = AddReply(_out, _count, REDIS_REPLY_TYPE_DOUBLE);
+        _out[_index].number = StringToDouble(ParseString(_pos + 1, _line_end));
+        return _next;
+
+      case REDIS_REPLY_TYPE_BOOL:
+        _index = AddReply(_out, _count, REDIS_REPLY_TYPE_BOOL);
+        _out[_index].integer = buffer[_pos + 1] == 't' ? 1 : 0;
+        return _next;
+
+      case REDIS_REPLY_TYPE_NIL:
+        AddReply(_out, _count, REDIS_REPLY_TYPE_NIL);
+        return _next;
+
+      case REDIS_REPLY_TYPE_STRING:
+      case REDIS_REPLY_TYPE_BLOB_ERROR:
+      case REDIS_REPLY_TYPE_VERBATIM:
+        _length = ParseInteger(_pos + 1, _line_end);
+        if (_length < 0) {
+          // RESP2's null bulk string.
+          AddReply(_out, _count, REDIS_REPLY_TYPE_NIL);
+          return _next;
+        }
+        if (_next + _length + 2 > end) {
+          return REDIS_PARSER_INCOMPLETE;
+        }
+        _index = AddReply(_out, _count, (ENUM_REDIS_REPLY_TYPE)_type);
+        if (_type == REDIS_REPLY_TYPE_VERBATIM && _length >= 4) {
+          // Skipping format, e.g., "txt:".
+          _out[_index].str = ParseString(_next + 4, _next + (int)_length);
+        } else {
+          _out[_index].str = ParseString(_next, _next + (int)_length);
+        }
+        return _next + (int)_length + 2;
+
+      case REDIS_REPLY_TYPE_ARRAY:
+      case REDIS_REPLY_TYPE_MAP:
+      case REDIS_REPLY_TYPE_SET:
+      case REDIS_REPLY_TYPE_PUSH:
+        _length = ParseInteger(_pos + 1, _line_end);
+        if (_length < 0) {
+          // RESP2's null array.
+          AddReply(_out, _count, REDIS_REPLY_TYPE_NIL);
+          return _next;
+        }
+        if (_type == REDIS_REPLY_TYPE_MAP) {
+          _length *= 2;
+        }
+        _index = AddReply(_out, _count, (ENUM_REDIS_REPLY_TYPE)_type);
+        _out[_index].num_items = (int)_length;
+        for (int i = 0; i < _length; ++i) {
+          _next = ParseValue(_next, _out, _count);
+          if (_next < 0) {
+            return _next;
+          }
+        }
+        _out[_index].next = _count;
+        return _next;
+
+      case '|':
+        // RESP3's attributes. Parsing and dropping them, as they precede the actual value.
+        {
+          int _count_before = _count;
+          _length = ParseInteger(_pos + 1, _line_end) * 2;
+          for (int i = 0; i < _length; ++i) {
+            _next = ParseValue(_next, _out, _count);
+            if (_next < 0) {
+              return _next;
+            }
+          }
+          _count = _count_before;
+        }
+        return ParseValue(_next, _out, _count);
+    }
+
+    return REDIS_PARSER_ERROR;
+  }
+
+ public:
+  /**
+   * Constructor.
+   */
+  RedisReplyParser(int _capacity = 4096) : start(0), end(0) { ArrayResize(buffer, _capacity); }
+
+  /**
+   * Appends received bytes.
+   */
+  void Feed(const unsigned char& _data[], int _length, int _offset = 0) {
+    Reserve(_length);
+    ArrayCopy(buffer, _data, end, _offset, _length);
+    end += _length;
+  }
+
+  /**
+   * Appends received text.
+   */
+  void Feed(const string _text) {
+    unsigned char _data[];
+    int _length = StringToCharArray(_text, _data, 0, WHOLE_ARRAY, CP_UTF8) - 1;
+    if (_length > 0) {
+      Feed(_data, _length);
+    }
+  }
+
+  /**
+   * Returns number of received, but not yet parsed bytes.
+   */
+  int GetPendingBytes() { return end - start; }
+
+  /**
+   * Returns the first unparsed byte or -1 if there are no unparsed bytes.
+   */
+  int PeekByte() { return start < end ? buffer[start] : -1; }
+
+  /**
+   * Consumes a single line terminated by "\r\n" or "\n" (e.g., inline command).
+   *
+   * @return
+   *   Returns false if line hasn't been completely received yet.
+   */
+  bool ReadLine(string& _line) {
+    for (int i = start; i < end; ++i) {
+      if (buffer[i] == '\n') {
+        _line = ParseString(start, i > start && buffer[i - 1] == '\r' ? i - 1 : i);
+        start = i + 1;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * Parses a single reply and appends its values into the given array.
+   *
+   * Data is consumed only when the whole reply has been received.
+   *
+   * @param _count
+   *   Number of values already stored in the array. Updated on success.
+   */
+  ENUM_REDIS_PARSE_RESULT Parse(RedisReply& _out[], int& _count) {
+    int _count_before = _count;
+    int _next = ParseValue(start, _out, _count);
+
+    if (_next < 0) {
+      _count = _count_before;
+      if (_next == REDIS_PARSER_ERROR) {
+        // Dropping the rest of the data, as we don't know where the next reply starts.
+        Clear();
+        return REDIS_PARSE_RESULT_ERROR;
+      }
+      return REDIS_PARSE_RESULT_INCOMPLETE;
+    }
+
+    start = _next;
+    if (start == end) {
+      start = end = 0;
+    }
+    return REDIS_PARSE_RESULT_OK;
+  }
+
+  /**
+   * Drops all received data.
+   */
+  void Clear() { start = end = 0; }
+};
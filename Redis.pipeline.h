@@ -0,0 +1,216 @@
+//+------------------------------------------------------------------+
+//|                                                EA31337 framework |
+//|                                 Copyright 2016-2022, EA31337 Ltd |
+//|                                       https://github.com/EA31337 |
+//+------------------------------------------------------------------+
+
+/*
+ * This file is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file
+ * Implements builder of pipelined Redis commands.
+ */
+
+#ifndef __MQL__
+// Allows the preprocessor to include a header file when it is needed.
+#pragma once
+#endif
+
+/**
+ * Builds batch of commands which is sent to Redis at once.
+ *
+ * Commands are encoded as RESP arrays of bulk strings into a reusable buffer,
+ * so N commands cost a single round-trip. Use Redis::Execute() to send them
+ * and to parse N replies.
+ */
+class RedisPipeline {
+ protected:
+  // Encoded commands.
+  unsigned char buffer[];
+
+  // Number of used bytes in the buffer.
+  int size;
+
+  // Temporary buffer for encoding single argument.
+  unsigned char arg[];
+
+  // Number of encoded commands.
+  int num_commands;
+
+  /**
+   * Ensures there is a space for the given number of bytes to be appended.
+   */
+  void Reserve(int _length) {
+    if (size + _length > ArraySize(buffer)) {
+      int _size = ArraySize(buffer) * 2;
+      ArrayResize(buffer, _size > size + _length ? _size : size + _length);
+    }
+  }
+
+  /**
+   * Appends ASCII text into the buffer.
+   */
+  void Write(const string _text) {
+    int _length = StringLen(_text);
+    Reserve(_length);
+    for (int i = 0; i < _length; ++i) {
+      buffer[size++] = (unsigned char)StringGetCharacter(_text, i);
+    }
+  }
+
+  /**
+   * Appends command's header.
+   */
+  void WriteHeader(int _num_args) {
+    Write("*" + IntegerToString(_num_args) + "\r\n");
+    ++num_commands;
+  }
+
+  /**
+   * Appends single argument as a bulk string.
+   */
+  void WriteArg(const string _value) {
+    int _length = StringToCharArray(_value, arg, 0, WHOLE_ARRAY, CP_UTF8) - 1;
+    if (_length < 0) {
+      _length = 0;
+    }
+    Write("$" + IntegerToString(_length) + "\r\n");
+    Reserve(_length + 2);
+    if (_length > 0) {
+      ArrayCopy(buffer, arg, size, 0, _length);
+      size += _length;
+    }
+    buffer[size++] = '\r';
+    buffer[size++] = '\n';
+  }
+
+ public:
+  /**
+   * Constructor.
+   */
+  RedisPipeline(int _capacity = 4096) : size(0), num_commands(0) { ArrayResize(buffer, _capacity); }
+
+  /* Getters */
+
+  /**
+   * Returns number of queued commands.
+   */
+  int GetCommandsCount() { return num_commands; }
+
+  /**
+   * Returns number of bytes of encoded commands.
+   */
+  int GetSize() { return size; }
+
+  /**
+   * Returns encoded commands. Only first GetSize() bytes are valid.
+   */
+  void GetData(unsigned char& _data[]) { ArrayCopy(_data, buffer, 0, 0, size); }
+
+  /* Commands */
+
+  /**
+   * Queues command with given arguments (the first one is a command's name).
+   */
+  RedisPipeline* Command(const string& _args[]) {
+    WriteHeader(ArraySize(_args));
+    for (int i = 0; i < ArraySize(_args); ++i) {
+      WriteArg(_args[i]);
+    }
+    return GetPointer(this);
+  }
+
+  /**
+   * Queues command without arguments.
+   */
+  RedisPipeline* Command(const string _name) {
+    WriteHeader(1);
+    WriteArg(_name);
+    return GetPointer(this);
+  }
+
+  /**
+   * Queues command with a single argument.
+   */
+  RedisPipeline* Command(const string _name, const string _arg1) {
+    WriteHeader(2);
+    WriteArg(_name);
+    WriteArg(_arg1);
+    return GetPointer(this);
+  }
+
+  /**
+   * Queues command with two arguments.
+   */
+  RedisPipeline* Command(const string _name, const string _arg1, const string _arg2) {
+    WriteHeader(3);
+    WriteArg(_name);
+    WriteArg(_arg1);
+    WriteArg(_arg2);
+    return GetPointer(this);
+  }
+
+  /**
+   * Queues SET command.
+   */
+  RedisPipeline* Set(const string _key, const string _value) { return Command("SET", _key, _value); }
+
+  /**
+   * Queues GET command.
+   */
+  RedisPipeline* Get(const string _key) { return Command("GET", _key); }
+
+  /**
+   * Queues INCRBY command.
+   */
+  RedisPipeline* IncrBy(const string _key, long _value) { return Command("INCRBY", _key, IntegerToString(_value)); }
+
+  /**
+   * Queues DEL command.
+   */
+  RedisPipeline* Del(const string _key) { return Command("DEL", _key); }
+
+  /**
+   * Queues PUBLISH command.
+   */
+  RedisPipeline* Publish(const string _channel, const string _message) {
+    return Command("PUBLISH", _channel, _message);
+  }
+
+  /**
+   * Starts transaction. Following commands are replied with "QUEUED" until EXEC.
+   */
+  RedisPipeline* Multi() { return Command("MULTI"); }
+
+  /**
+   * Executes transaction. Replied with array of replies of all queued commands.
+   */
+  RedisPipeline* Exec() { return Command("EXEC"); }
+
+  /**
+   * Discards transaction.
+   */
+  RedisPipeline* Discard() { return Command("DISCARD"); }
+
+  /**
+   * Removes all queued commands. Buffer is kept for reuse.
+   */
+  void Clear() {
+    size = 0;
+    num_commands = 0;
+  }
+};
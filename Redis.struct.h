@@ -31,6 +31,7 @@
 #endif
 
 // Includes.
+#include "Redis.enum.h"
 #include "SerializerConversions.h"
 
 // Forward declaration.
@@ -139,6 +140,8 @@ struct RedisMessage {
 
       string rest = StringSubstr(message, i);
 
+      // Items' positions are relative to the rest of the message.
+      i = 0;
       for (int item = 0; item < num_items; ++item) {
         i = ParseItem(rest, i);
       }
@@ -205,3 +208,74 @@ struct RedisMessage {
     return i;
   }
 };
+
+/**
+ * Single value parsed from the Redis reply.
+ *
+ * Aggregate replies (arrays, maps, sets and pushes) are stored in a flat array
+ * in pre-order, i.e., aggregate is followed by its items. Index of the value
+ * which follows the whole aggregate is kept in "next".
+ */
+struct RedisReply {
+  // Type of the value.
+  ENUM_REDIS_REPLY_TYPE type;
+
+  // Status, error, bulk string, verbatim string or big number.
+  string str;
+
+  // Integer or boolean value.
+  long integer;
+
+  // Double value.
+  double number;
+
+  // Number of items for aggregate types. For maps it is number of keys and values.
+  int num_items;
+
+  // Index of the value which follows this value and all its items.
+  int next;
+
+  /**
+   * Constructor.
+   */
+  RedisReply() : type(REDIS_REPLY_TYPE_NONE), integer(0), number(0), num_items(0), next(0) {}
+
+  /**
+   * Checks whether value is an aggregate of other values.
+   */
+  bool IsAggregate() {
+    return type == REDIS_REPLY_TYPE_ARRAY || type == REDIS_REPLY_TYPE_MAP || type == REDIS_REPLY_TYPE_SET ||
+           type == REDIS_REPLY_TYPE_PUSH;
+  }
+
+  /**
+   * Checks whether value is an error.
+   */
+  bool IsError() { return type == REDIS_REPLY_TYPE_ERROR || type == REDIS_REPLY_TYPE_BLOB_ERROR; }
+
+  /**
+   * Checks whether value is a null.
+   */
+  bool IsNil() { return type == REDIS_REPLY_TYPE_NIL; }
+
+  /**
+   * Returns textual representation of a non-aggregate value or NULL for null and errors.
+   */
+  string ToString() {
+    switch (type) {
+      case REDIS_REPLY_TYPE_STATUS:
+      case REDIS_REPLY_TYPE_STRING:
+      case REDIS_REPLY_TYPE_VERBATIM:
+      case REDIS_REPLY_TYPE_BIGNUM:
+        return str;
+      case REDIS_REPLY_TYPE_INTEGER:
+      case REDIS_REPLY_TYPE_BOOL:
+        return IntegerToString(integer);
+      case REDIS_REPLY_TYPE_DOUBLE:
+        return DoubleToString(number);
+      default:
+        break;
+    }
+    return NULL;
+  }
+};
@@ -36,6 +36,11 @@
 // Forward declarations.
 class Dynamic;
 
+#ifndef REFS_POOL_SIZE
+// Maximum number of freed reference counters kept for reuse (when __refs_pool__ is defined).
+#define REFS_POOL_SIZE 4096
+#endif
+
 class ReferenceCounter {
  public:
   /**
@@ -58,6 +63,31 @@ class ReferenceCounter {
    */
   bool deleted;
 
+  /**
+   * Next free reference counter in the pool.
+   */
+  ReferenceCounter* ptr_next_free;
+
+  /**
+   * Head of the list of free reference counters.
+   */
+  static ReferenceCounter* pool_head;
+
+  /**
+   * Number of reference counters in the pool.
+   */
+  static int pool_size;
+
+  /**
+   * Number of reference counters allocated on the heap.
+   */
+  static unsigned long num_allocs;
+
+  /**
+   * Number of reference counters taken from the pool.
+   */
+  static unsigned long num_reuses;
+
   /**
    * Constructor.
    */
@@ -66,6 +96,7 @@ class ReferenceCounter {
     num_strong_refs = 0;
     ptr_object = NULL;
     deleted = false;
+    ptr_next_free = NULL;
   }
 
   string Debug() { return StringFormat("%d: %d strong, %d weak", ptr_object, num_strong_refs, num_weak_refs); }
@@ -74,12 +105,85 @@ class ReferenceCounter {
    * ReferenceCounter class allocator.
    */
   static ReferenceCounter* alloc();
+
+  /**
+   * ReferenceCounter class deallocator.
+   */
+  static void free(ReferenceCounter* _ptr);
+
+  /**
+   * Deletes reference counters kept in the pool.
+   */
+  static void PoolClear();
 };
 
+ReferenceCounter* ReferenceCounter::pool_head = NULL;
+int ReferenceCounter::pool_size = 0;
+unsigned long ReferenceCounter::num_allocs = 0;
+unsigned long ReferenceCounter::num_reuses = 0;
+
 /**
  * ReferenceCounter class allocator.
+ *
+ * When __refs_pool__ is defined, previously freed reference counters are reused.
  */
 ReferenceCounter* ReferenceCounter::alloc() {
-  // @todo Enhance with linked-list object reuse.
+#ifdef __refs_pool__
+  if (pool_head != NULL) {
+    ReferenceCounter* _ptr = pool_head;
+    pool_head = PTR_ATTRIB(_ptr, ptr_next_free);
+    --pool_size;
+    PTR_ATTRIB(_ptr, num_weak_refs) = 0;
+    PTR_ATTRIB(_ptr, num_strong_refs) = 0;
+    PTR_ATTRIB(_ptr, ptr_object) = NULL;
+    PTR_ATTRIB(_ptr, deleted) = false;
+    PTR_ATTRIB(_ptr, ptr_next_free) = NULL;
+    ++num_reuses;
+    return _ptr;
+  }
+#endif
+  ++num_allocs;
   return new ReferenceCounter();
 }
+
+/**
+ * ReferenceCounter class deallocator.
+ *
+ * When __refs_pool__ is defined, reference counter is kept for reuse (up to REFS_POOL_SIZE counters).
+ */
+void ReferenceCounter::free(ReferenceCounter* _ptr) {
+#ifdef __refs_pool__
+  if (pool_size < REFS_POOL_SIZE) {
+    PTR_ATTRIB(_ptr, ptr_object) = NULL;
+    PTR_ATTRIB(_ptr, ptr_next_free) = pool_head;
+    pool_head = _ptr;
+    ++pool_size;
+    return;
+  }
+#endif
+  delete _ptr;
+}
+
+/**
+ * Deletes reference counters kept in the pool.
+ */
+void ReferenceCounter::PoolClear() {
+  while (pool_head != NULL) {
+    ReferenceCounter* _ptr = pool_head;
+    pool_head = PTR_ATTRIB(_ptr, ptr_next_free);
+    delete _ptr;
+  }
+  pool_size = 0;
+}
+
+#ifdef __refs_pool__
+/**
+ * Frees pooled reference counters on program's exit.
+ */
+class ReferenceCounterPoolCleaner {
+ public:
+  ~ReferenceCounterPoolCleaner() { ReferenceCounter::PoolClear(); }
+};
+
+ReferenceCounterPoolCleaner _refs_pool_cleaner;
+#endif
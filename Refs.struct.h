@@ -52,7 +52,7 @@ struct SimpleRef {
   /**
    * Constructor.
    */
-  SimpleRef(X* _ptr) { this = _ptr; }
+  SimpleRef(X* _ptr) : ptr_object(NULL) { THIS_REF = _ptr; }
 
   /**
    * Destructor.
@@ -101,23 +101,30 @@ struct Ref {
   /**
    * Constructor.
    */
-  Ref(X* _ptr) { THIS_REF = _ptr; }
+  Ref(X* _ptr) : ptr_object(NULL) { THIS_REF = _ptr; }
 
   /**
    * Constructor.
    */
-  Ref(Ref<X>& ref) { THIS_REF = ref.Ptr(); }
+  Ref(Ref<X>& ref) : ptr_object(NULL) { THIS_REF = ref.Ptr(); }
 
   /**
    * Constructor.
    */
-  Ref(WeakRef<X>& ref) { THIS_REF = ref.Ptr(); }
+  Ref(WeakRef<X>& ref) : ptr_object(NULL) { THIS_REF = ref.Ptr(); }
 
   /**
    * Constructor.
    */
   Ref() { ptr_object = NULL; }
 
+#ifndef __MQL__
+  /**
+   * Move constructor. Takes over the reference without touching reference counts.
+   */
+  Ref(Ref<X>&& ref) : ptr_object(ref.ptr_object) { ref.ptr_object = NULL; }
+#endif
+
   /**
    * Destructor.
    */
@@ -169,7 +176,7 @@ struct Ref {
 #endif
 
           // Also no more weak references.
-          delete PTR_ATTRIB(ptr_object, ptr_ref_counter);
+          ReferenceCounter::free(PTR_ATTRIB(ptr_object, ptr_ref_counter));
           PTR_ATTRIB(ptr_object, ptr_ref_counter) = NULL;
         } else {
           // Object becomes deleted, but there are some weak references.
@@ -253,6 +260,23 @@ struct Ref {
     return Ptr();
   }
 
+#ifndef __MQL__
+  /**
+   * Takes over the reference from the strongly-referenced object.
+   */
+  X* operator=(Ref<X>&& right) {
+    if (ptr_object == right.ptr_object) {
+      // The same object, dropping one of the references.
+      right.Unset();
+      return Ptr();
+    }
+    Unset();
+    ptr_object = right.ptr_object;
+    right.ptr_object = NULL;
+    return Ptr();
+  }
+#endif
+
   /**
    * Equality operator.
    */
@@ -273,17 +297,17 @@ struct WeakRef {
   /**
    * Constructor.
    */
-  WeakRef(X* _ptr = NULL) { this = _ptr; }
+  WeakRef(X* _ptr = NULL) : ptr_ref_counter(NULL) { THIS_REF = _ptr; }
 
   /**
    * Constructor.
    */
-  WeakRef(WeakRef<X>& ref) { this = ref.Ptr(); }
+  WeakRef(WeakRef<X>& ref) : ptr_ref_counter(NULL) { THIS_REF = ref.Ptr(); }
 
   /**
    * Constructor.
    */
-  WeakRef(Ref<X>& ref) { this = ref.Ptr(); }
+  WeakRef(Ref<X>& ref) : ptr_ref_counter(NULL) { THIS_REF = ref.Ptr(); }
 
   /**
    * Destructor.
@@ -330,7 +354,7 @@ struct WeakRef {
    * Makes a weak reference to the given weakly-referenced object.
    */
   X* operator=(WeakRef<X>& right) {
-    this = right.Ptr();
+    THIS_REF = right.Ptr();
     return Ptr();
   }
 
@@ -338,7 +362,7 @@ struct WeakRef {
    * Makes a weak reference to the strongly-referenced object.
    */
   X* operator=(Ref<X>& right) {
-    this = right.Ptr();
+    THIS_REF = right.Ptr();
     return Ptr();
   }
 
@@ -397,7 +421,7 @@ struct WeakRef {
           }
 #endif
 
-          delete stored_ptr_ref_counter;
+          ReferenceCounter::free(stored_ptr_ref_counter);
         }
       }
     }
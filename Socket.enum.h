@@ -0,0 +1,39 @@
+//+------------------------------------------------------------------+
+//|                                                EA31337 framework |
+//|                                 Copyright 2016-2022, EA31337 Ltd |
+//|                                       https://github.com/EA31337 |
+//+------------------------------------------------------------------+
+
+/*
+ * This file is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file
+ * Includes Socket's enums.
+ */
+
+#ifndef __MQL__
+// Allows the preprocessor to include a header file when it is needed.
+#pragma once
+#endif
+
+// Socket's readiness events (flags).
+enum ENUM_SOCKET_EVENT {
+  SOCKET_EVENT_NONE = 0,        // No events.
+  SOCKET_EVENT_READ = 1 << 0,   // Received data is available to be read.
+  SOCKET_EVENT_WRITE = 1 << 1,  // All pending data has been sent.
+  SOCKET_EVENT_ERROR = 1 << 2,  // Connection has been closed or an error occurred.
+};
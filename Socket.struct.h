@@ -0,0 +1,211 @@
+//+------------------------------------------------------------------+
+//|                                                EA31337 framework |
+//|                                 Copyright 2016-2022, EA31337 Ltd |
+//|                                       https://github.com/EA31337 |
+//+------------------------------------------------------------------+
+
+/*
+ * This file is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file
+ * Includes Socket's structs.
+ */
+
+#ifndef __MQL__
+// Allows the preprocessor to include a header file when it is needed.
+#pragma once
+#endif
+
+// Includes.
+#include "Std.h"
+
+#ifndef __MQL__
+#include "Array.extern.h"
+#endif
+
+/**
+ * Preallocated ring buffer of bytes used for sending and receiving socket data.
+ */
+struct SocketBuffer {
+ protected:
+  // Stored bytes.
+  ARRAY(unsigned char, data);
+
+  // Position of the first stored byte.
+  int head;
+
+  // Number of stored bytes.
+  int size;
+
+ public:
+  /**
+   * Constructor.
+   */
+  SocketBuffer(int _capacity = 4096) : head(0), size(0) { ArrayResize(data, _capacity > 0 ? _capacity : 1); }
+
+  /* Getters */
+
+  /**
+   * Returns size of the allocated memory.
+   */
+  int GetCapacity() { return ArraySize(data); }
+
+  /**
+   * Returns number of stored bytes.
+   */
+  int Size() { return size; }
+
+  /**
+   * Returns number of bytes which can be appended without growing the buffer.
+   */
+  int GetFree() { return ArraySize(data) - size; }
+
+  /**
+   * Checks whether there are no stored bytes.
+   */
+  bool IsEmpty() { return size == 0; }
+
+  /**
+   * Returns position of the first stored byte.
+   */
+  int GetReadPos() { return head; }
+
+  /**
+   * Returns number of stored bytes available contiguously from the read position.
+   */
+  int GetReadSpan() {
+    int _span = ArraySize(data) - head;
+    return size < _span ? size : _span;
+  }
+
+  /**
+   * Returns position after the last stored byte.
+   */
+  int GetWritePos() { return (head + size) % ArraySize(data); }
+
+  /**
+   * Returns number of free bytes available contiguously from the write position.
+   */
+  int GetWriteSpan() {
+    int _tail = GetWritePos();
+    if (size == ArraySize(data)) {
+      return 0;
+    }
+    return _tail >= head ? ArraySize(data) - _tail : head - _tail;
+  }
+
+  /**
+   * Returns stored byte at a given offset from the first stored byte.
+   */
+  unsigned char GetByte(int _offset) { return data[(head + _offset) % ArraySize(data)]; }
+
+#ifndef __MQL__
+  /**
+   * Returns pointer to the given position, so system calls may read or write data in-place.
+   */
+  unsigned char* GetPtr(int _pos) { return &data[_pos]; }
+#endif
+
+  /* Setters */
+
+  /**
+   * Grows the buffer, so it can store at least given number of bytes. Stored bytes are kept.
+   */
+  void Reserve(int _capacity) {
+    if (_capacity <= ArraySize(data)) {
+      return;
+    }
+    int _old_capacity = ArraySize(data);
+    int _new_capacity = _old_capacity * 2 > _capacity ? _old_capacity * 2 : _capacity;
+    ArrayResize(data, _new_capacity);
+    if (head + size > _old_capacity) {
+      // Moving wrapped part after the old end of the buffer.
+      int _wrapped = head + size - _old_capacity;
+      for (int i = 0; i < _wrapped; ++i) {
+        data[_old_capacity + i] = data[i];
+      }
+    }
+  }
+
+  /**
+   * Marks given number of bytes written at the write position as stored.
+   */
+  void Commit(int _length) { size += _length; }
+
+  /**
+   * Drops given number of bytes from the beginning.
+   */
+  void Consume(int _length) {
+    _length = _length < size ? _length : size;
+    size -= _length;
+    head = size == 0 ? 0 : (head + _length) % ArraySize(data);
+  }
+
+  /**
+   * Appends bytes. Grows the buffer if there is no enough space.
+   */
+  void Write(const ARRAY_REF(unsigned char, _src), int _length, int _offset = 0) {
+    Reserve(size + _length);
+    int _capacity = ArraySize(data);
+    int _pos = GetWritePos();
+    for (int i = 0; i < _length; ++i) {
+      data[_pos] = _src[_offset + i];
+      _pos = _pos + 1 < _capacity ? _pos + 1 : 0;
+    }
+    size += _length;
+  }
+
+  /**
+   * Copies up to given number of stored bytes without consuming them.
+   *
+   * @return
+   *   Returns number of copied bytes.
+   */
+  int Peek(ARRAY_REF(unsigned char, _dst), int _max_length, int _dst_offset = 0) {
+    int _length = _max_length < size ? _max_length : size;
+    if (ArraySize(_dst) < _dst_offset + _length) {
+      ArrayResize(_dst, _dst_offset + _length);
+    }
+    int _capacity = ArraySize(data);
+    int _pos = head;
+    for (int i = 0; i < _length; ++i) {
+      _dst[_dst_offset + i] = data[_pos];
+      _pos = _pos + 1 < _capacity ? _pos + 1 : 0;
+    }
+    return _length;
+  }
+
+  /**
+   * Copies and consumes up to given number of stored bytes.
+   *
+   * @return
+   *   Returns number of read bytes.
+   */
+  int Read(ARRAY_REF(unsigned char, _dst), int _max_length, int _dst_offset = 0) {
+    int _length = Peek(_dst, _max_length, _dst_offset);
+    Consume(_length);
+    return _length;
+  }
+
+  /**
+   * Removes all stored bytes. Memory is kept for reuse.
+   */
+  void Clear() {
+    head = 0;
+    size = 0;
+  }
+};
@@ -0,0 +1,165 @@
+//+------------------------------------------------------------------+
+//|                                                EA31337 framework |
+//|                                 Copyright 2016-2022, EA31337 Ltd |
+//|                                       https://github.com/EA31337 |
+//+------------------------------------------------------------------+
+
+/*
+ *  This file is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file
+ * Streaming Fractals calculation.
+ */
+
+#ifndef __MQL__
+// Allows the preprocessor to include a header file when it is needed.
+#pragma once
+#endif
+
+// Prevents processing this includes file multiple times.
+#ifndef FRACTALS_STREAM_H
+#define FRACTALS_STREAM_H
+
+// Includes.
+#include "../Refs.mqh"
+#include "../Std.h"
+#include "PivotList.h"
+#include "ValueStorage.h"
+
+// Defines.
+#define FRACTALS_STREAM_BARS 5  // Number of bars forming a fractal.
+
+/**
+ * Calculates Fractals (the same way as the "Examples\Fractals" indicator does) one bar at a time.
+ *
+ * Fractal of a bar is known once two more bars are completed, so only the last five completed bars are kept and
+ * fractals are stored as compact pivot lists. The forming bar is never used.
+ */
+class FractalsStream : public Dynamic {
+ protected:
+  // High and low prices of the last completed bars, indexed by the bar index modulo FRACTALS_STREAM_BARS.
+  double highs[FRACTALS_STREAM_BARS];
+  double lows[FRACTALS_STREAM_BARS];
+
+  // Fractals found so far.
+  PivotList upper;
+  PivotList lower;
+
+  // Number of completed bars processed.
+  int num_bars;
+
+  /**
+   * Returns high price of the recently processed bar at a given index.
+   */
+  double GetHigh(int _index) { return highs[_index % FRACTALS_STREAM_BARS]; }
+
+  /**
+   * Returns low price of the recently processed bar at a given index.
+   */
+  double GetLow(int _index) { return lows[_index % FRACTALS_STREAM_BARS]; }
+
+ public:
+  /* Special methods */
+
+  /**
+   * Class constructor.
+   */
+  FractalsStream() { Clear(); }
+
+  /* Getters */
+
+  /**
+   * Returns number of processed completed bars.
+   */
+  int GetCompletedBars() { return num_bars; }
+
+  /**
+   * Returns upper fractals.
+   */
+  PivotList *GetUpperPivots() { return &upper; }
+
+  /**
+   * Returns lower fractals.
+   */
+  PivotList *GetLowerPivots() { return &lower; }
+
+  /**
+   * Returns upper fractal of the bar at a given index (0 is the oldest bar) or given empty value if there is none.
+   */
+  double GetUpper(int _index, double _empty_value = EMPTY_VALUE) { return upper.Get(_index, _empty_value); }
+
+  /**
+   * Returns lower fractal of the bar at a given index (0 is the oldest bar) or given empty value if there is none.
+   */
+  double GetLower(int _index, double _empty_value = EMPTY_VALUE) { return lower.Get(_index, _empty_value); }
+
+  /* Main methods */
+
+  /**
+   * Processes the next completed bar (e.g. on the new bar event). Checks whether the bar two bars ago is a fractal.
+   */
+  void ProcessBar(double _high, double _low) {
+    highs[num_bars % FRACTALS_STREAM_BARS] = _high;
+    lows[num_bars % FRACTALS_STREAM_BARS] = _low;
+    ++num_bars;
+
+    int i = num_bars - 3;
+    if (i < 2) {
+      return;
+    }
+    double _mid_high = GetHigh(i);
+    if (_mid_high > GetHigh(i + 1) && _mid_high > GetHigh(i + 2) && _mid_high >= GetHigh(i - 1) &&
+        _mid_high >= GetHigh(i - 2)) {
+      upper.Set(i, _mid_high);
+    }
+    double _mid_low = GetLow(i);
+    if (_mid_low < GetLow(i + 1) && _mid_low < GetLow(i + 2) && _mid_low <= GetLow(i - 1) &&
+        _mid_low <= GetLow(i - 2)) {
+      lower.Set(i, _mid_low);
+    }
+  }
+
+  /**
+   * Processes new completed bars of given prices. The last bar is treated as the forming one and is skipped.
+   *
+   * Completed bars are processed only once, so prices of bars which have already been processed must stay the same.
+   */
+  void Update(ValueStorage<double> &_high, ValueStorage<double> &_low, int _total) {
+    if (_total - 1 < num_bars) {
+      // History has been shortened.
+      Clear();
+    }
+    while (num_bars < _total - 1) {
+      ProcessBar(_high[num_bars].Get(), _low[num_bars].Get());
+    }
+  }
+
+  /**
+   * Removes all processed bars.
+   */
+  void Clear() {
+    for (int i = 0; i < FRACTALS_STREAM_BARS; ++i) {
+      highs[i] = 0.0;
+      lows[i] = 0.0;
+    }
+    upper.Clear();
+    lower.Clear();
+    num_bars = 0;
+  }
+};
+
+#endif  // FRACTALS_STREAM_H
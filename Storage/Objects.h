@@ -32,9 +32,25 @@
 // Includes.
 #include "../DictStruct.mqh"
 #include "../Refs.mqh"
+#include "ObjectsByKey.h"
+#include "ObjectsKey.h"
 
 /**
- * Stores objects to be reused using a string-based key.
+ * Holds reference to the object stored by the hashed key.
+ */
+template <typename C>
+class ObjectsEntry {
+ public:
+  Ref<C> ptr;
+
+  /**
+   * Class constructor.
+   */
+  ObjectsEntry(C* _ptr) { ptr = _ptr; }
+};
+
+/**
+ * Stores objects to be reused using a string-based or a hashed composite key.
  */
 template <typename C>
 class Objects {
@@ -44,6 +60,9 @@ class Objects {
     return &objects;
   }
 
+  // Registry of hashed key => reference to object.
+  static ObjectsByKey<ObjectsEntry<C>>* GetObjectsByKey() { return ObjectsByKey<ObjectsEntry<C>>::GetInstance(); }
+
  public:
   /**
    * Tries to retrieve pointer to object for a given key. Returns true if object did exist.
@@ -67,4 +86,25 @@ class Objects {
     GetObjects().Set(key, _ref);
     return ptr;
   }
+
+  /**
+   * Tries to retrieve pointer to object for a given hashed key. Returns true if object did exist.
+   */
+  static bool TryGet(const ObjectsKey& _key, C*& _out_ptr) {
+    ObjectsEntry<C>* _entry;
+    if (!GetObjectsByKey().TryGet(_key, _entry)) {
+      _out_ptr = NULL;
+      return false;
+    }
+    _out_ptr = _entry.ptr.Ptr();
+    return true;
+  }
+
+  /**
+   * Stores object pointer with a given hashed key.
+   */
+  static C* Set(const ObjectsKey& _key, C* _ptr) {
+    GetObjectsByKey().Set(_key, new ObjectsEntry<C>(_ptr));
+    return _ptr;
+  }
 };
@@ -0,0 +1,401 @@
+//+------------------------------------------------------------------+
+//|                                                EA31337 framework |
+//|                                 Copyright 2016-2022, EA31337 Ltd |
+//|                                       https://github.com/EA31337 |
+//+------------------------------------------------------------------+
+
+/*
+ *  This file is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file
+ * Objects registry per composite key.
+ */
+
+#ifndef __MQL__
+// Allows the preprocessor to include a header file when it is needed.
+#pragma once
+#endif
+
+// Includes.
+#include "../Std.h"
+#include "ObjectsKey.h"
+
+/**
+ * Stores objects to be reused using a hashed composite key.
+ *
+ * Registry owns stored objects and deletes them when evicted or on destruction.
+ * When maximum size is set, the least recently used object is evicted on insertion
+ * of a new one. Objects in use by the caller should be pinned (e.g. by ObjectsByKeyPin),
+ * as pinned objects are never evicted.
+ *
+ * Usage:
+ *
+ *   ObjectsKey _key = ObjectsKey::Make(_symbol, (int)_tf);
+ *   if (!ObjectsByKey<Foo>::GetInstance().TryGet(_key, _foo)) {
+ *     _foo = ObjectsByKey<Foo>::GetInstance().Set(_key, new Foo());
+ *   }
+ */
+template <typename C>
+class ObjectsByKey {
+ protected:
+  ARRAY(ObjectsKey, keys);
+  ARRAY(C*, objects);
+  ARRAY(unsigned long, last_used);  // Value of the clock when object has been used for the last time.
+  ARRAY(int, next);                 // Next entry in the bucket or in the list of free entries.
+  ARRAY(int, buckets);              // First entry of the bucket.
+  ARRAY(int, lru_prev);             // Previous (less recently used) entry in the list of used entries.
+  ARRAY(int, lru_next);             // Next (more recently used) entry in the list of used entries.
+  ARRAY(int, pins);                 // Number of pins. Pinned entries are kept out of the list of used entries.
+  unsigned long clock;              // Number of lookups.
+  int count;
+  int free_head;  // First free entry.
+  int lru_head;   // Least recently used entry.
+  int lru_tail;   // Most recently used entry.
+  int max_size;   // Maximum number of stored objects (0 - unlimited).
+
+  /**
+   * Returns bucket for a given key.
+   */
+  int GetBucket(const ObjectsKey &_key) { return (int)(_key.hash % (unsigned long)ArraySize(buckets)); }
+
+  /**
+   * Returns entry for a given key or -1 if not found.
+   */
+  int Find(const ObjectsKey &_key) {
+    if (ArraySize(buckets) == 0) {
+      return -1;
+    }
+    for (int i = buckets[GetBucket(_key)]; i != -1; i = next[i]) {
+      if (keys[i].Equals(_key)) {
+        return i;
+      }
+    }
+    return -1;
+  }
+
+  /**
+   * Removes given entry from the list of used entries.
+   */
+  void Unlink(int _entry) {
+    if (lru_prev[_entry] != -1) {
+      lru_next[lru_prev[_entry]] = lru_next[_entry];
+    } else {
+      lru_head = lru_next[_entry];
+    }
+    if (lru_next[_entry] != -1) {
+      lru_prev[lru_next[_entry]] = lru_prev[_entry];
+    } else {
+      lru_tail = lru_prev[_entry];
+    }
+  }
+
+  /**
+   * Appends given entry to the list of used entries as the most recently used one.
+   */
+  void LinkLast(int _entry) {
+    lru_prev[_entry] = lru_tail;
+    lru_next[_entry] = -1;
+    if (lru_tail != -1) {
+      lru_next[lru_tail] = _entry;
+    } else {
+      lru_head = _entry;
+    }
+    lru_tail = _entry;
+  }
+
+  /**
+   * Marks given entry as the most recently used one.
+   */
+  void Touch(int _entry) {
+    last_used[_entry] = ++clock;
+    if (pins[_entry] == 0 && lru_tail != _entry) {
+      Unlink(_entry);
+      LinkLast(_entry);
+    }
+  }
+
+  /**
+   * Rebuilds buckets for a given number of buckets.
+   */
+  void Rehash(int _num_buckets) {
+    ArrayResize(buckets, _num_buckets);
+    for (int i = 0; i < _num_buckets; ++i) {
+      buckets[i] = -1;
+    }
+    for (int i = 0; i < ArraySize(objects); ++i) {
+      if (objects[i] != NULL) {
+        int _bucket = GetBucket(keys[i]);
+        next[i] = buckets[_bucket];
+        buckets[_bucket] = i;
+      }
+    }
+  }
+
+  /**
+   * Removes given entry and deletes its object.
+   */
+  void RemoveEntry(int _entry) {
+    int _bucket = GetBucket(keys[_entry]);
+    if (buckets[_bucket] == _entry) {
+      buckets[_bucket] = next[_entry];
+    } else {
+      for (int i = buckets[_bucket]; i != -1; i = next[i]) {
+        if (next[i] == _entry) {
+          next[i] = next[_entry];
+          break;
+        }
+      }
+    }
+    if (pins[_entry] == 0) {
+      Unlink(_entry);
+    }
+    pins[_entry] = 0;
+    delete objects[_entry];
+    objects[_entry] = NULL;
+    next[_entry] = free_head;
+    free_head = _entry;
+    --count;
+  }
+
+ public:
+  /**
+   * Constructor.
+   */
+  ObjectsByKey(int _max_size = 0)
+      : clock(0), count(0), free_head(-1), lru_head(-1), lru_tail(-1), max_size(_max_size) {}
+
+  /**
+   * Destructor.
+   */
+  ~ObjectsByKey() { Clear(); }
+
+  /**
+   * Returns registry for the given type of objects.
+   */
+  static ObjectsByKey<C>* GetInstance() {
+    static ObjectsByKey<C> _instance;
+    return &_instance;
+  }
+
+  /* Getters */
+
+  /**
+   * Returns maximum number of stored objects (0 - unlimited).
+   */
+  int GetMaxSize() { return max_size; }
+
+  /**
+   * Returns number of stored objects.
+   */
+  int Size() { return count; }
+
+  /**
+   * Returns number of entries including the free ones (to iterate with GetByEntry()).
+   */
+  int GetNumEntries() { return ArraySize(objects); }
+
+  /**
+   * Returns object stored in a given entry or NULL if entry is free. Doesn't count as use of the object.
+   */
+  C* GetByEntry(int _entry) { return objects[_entry]; }
+
+  /**
+   * Checks whether object stored in a given entry is pinned.
+   */
+  bool IsPinned(int _entry) { return _entry < ArraySize(pins) && pins[_entry] > 0; }
+
+  /**
+   * Tries to retrieve pointer to object for a given key. Returns true if object did exist.
+   */
+  bool TryGet(const ObjectsKey &_key, C*& _out_ptr) {
+    int _entry = Find(_key);
+    if (_entry == -1) {
+      _out_ptr = NULL;
+      return false;
+    }
+    Touch(_entry);
+    _out_ptr = objects[_entry];
+    return true;
+  }
+
+  /* Setters */
+
+  /**
+   * Sets maximum number of stored objects (0 - unlimited).
+   */
+  void SetMaxSize(int _max_size) { max_size = _max_size; }
+
+  /**
+   * Stores object pointer with a given key. Previously stored object with the same key is deleted.
+   */
+  C* Set(const ObjectsKey &_key, C* _ptr) {
+    int _entry = Find(_key);
+    if (_entry != -1) {
+      if (objects[_entry] != _ptr) {
+        delete objects[_entry];
+        objects[_entry] = _ptr;
+      }
+      Touch(_entry);
+      return _ptr;
+    }
+    if (max_size > 0 && count >= max_size) {
+      EvictLeastRecentlyUsed();
+    }
+    if (free_head != -1) {
+      _entry = free_head;
+      free_head = next[_entry];
+    } else {
+      _entry = ArraySize(objects);
+      ArrayResize(keys, _entry + 1, 32);
+      ArrayResize(objects, _entry + 1, 32);
+      ArrayResize(last_used, _entry + 1, 32);
+      ArrayResize(next, _entry + 1, 32);
+      ArrayResize(lru_prev, _entry + 1, 32);
+      ArrayResize(lru_next, _entry + 1, 32);
+      ArrayResize(pins, _entry + 1, 32);
+    }
+    keys[_entry] = _key;
+    pins[_entry] = 0;
+    objects[_entry] = _ptr;
+    last_used[_entry] = ++clock;
+    LinkLast(_entry);
+    ++count;
+    if (count > ArraySize(buckets) * 3 / 4) {
+      // Rehash also links the new entry.
+      Rehash(ArraySize(buckets) > 0 ? ArraySize(buckets) * 2 : 16);
+    } else {
+      int _bucket = GetBucket(_key);
+      next[_entry] = buckets[_bucket];
+      buckets[_bucket] = _entry;
+    }
+    return _ptr;
+  }
+
+  /* Pinning methods */
+
+  /**
+   * Pins object stored with a given key, so it won't be evicted until unpinned.
+   *
+   * @return
+   *   Returns pinned entry or -1 if there is no object for a given key.
+   */
+  int Pin(const ObjectsKey &_key) {
+    int _entry = Find(_key);
+    if (_entry != -1 && pins[_entry]++ == 0) {
+      Unlink(_entry);
+    }
+    return _entry;
+  }
+
+  /**
+   * Releases pin of a given entry. Entry becomes the most recently used one after its last pin is released.
+   */
+  void Unpin(int _entry) {
+    if (!IsPinned(_entry) || --pins[_entry] > 0) {
+      return;
+    }
+    last_used[_entry] = ++clock;
+    LinkLast(_entry);
+  }
+
+  /* Eviction methods */
+
+  /**
+   * Deletes objects which haven't been used within the last given number of lookups.
+   *
+   * @return
+   *   Returns number of deleted objects.
+   */
+  int Evict(unsigned long _max_idle) {
+    int _evicted = 0;
+    // Entries are ordered by their last use, so only the idle ones are visited.
+    while (lru_head != -1 && last_used[lru_head] + _max_idle < clock) {
+      RemoveEntry(lru_head);
+      ++_evicted;
+    }
+    return _evicted;
+  }
+
+  /**
+   * Deletes object stored in a given entry, unless it is pinned.
+   */
+  void EvictEntry(int _entry) {
+    if (objects[_entry] != NULL && pins[_entry] == 0) {
+      RemoveEntry(_entry);
+    }
+  }
+
+  /**
+   * Deletes the least recently used object which isn't pinned.
+   */
+  bool EvictLeastRecentlyUsed() {
+    if (lru_head == -1) {
+      return false;
+    }
+    RemoveEntry(lru_head);
+    return true;
+  }
+
+  /**
+   * Deletes all stored objects.
+   */
+  void Clear() {
+    for (int i = 0; i < ArraySize(objects); ++i) {
+      if (objects[i] != NULL) {
+        delete objects[i];
+      }
+    }
+    ArrayResize(keys, 0);
+    ArrayResize(objects, 0);
+    ArrayResize(last_used, 0);
+    ArrayResize(next, 0);
+    ArrayResize(buckets, 0);
+    ArrayResize(lru_prev, 0);
+    ArrayResize(lru_next, 0);
+    ArrayResize(pins, 0);
+    count = 0;
+    free_head = -1;
+    lru_head = -1;
+    lru_tail = -1;
+  }
+};
+
+/**
+ * Pins object stored in the registry for the lifetime of the pin (e.g. for the scope of the calculation).
+ */
+template <typename C>
+class ObjectsByKeyPin {
+ protected:
+  ObjectsByKey<C>* registry;
+  int entry;
+
+ public:
+  /**
+   * Constructor.
+   */
+  ObjectsByKeyPin(ObjectsByKey<C>* _registry, const ObjectsKey &_key) : registry(_registry) {
+    entry = registry PTR_DEREF Pin(_key);
+  }
+
+  /**
+   * Destructor.
+   */
+  ~ObjectsByKeyPin() {
+    if (entry != -1) {
+      registry PTR_DEREF Unpin(entry);
+    }
+  }
+};
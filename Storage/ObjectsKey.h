@@ -0,0 +1,195 @@
+//+------------------------------------------------------------------+
+//|                                                EA31337 framework |
+//|                                 Copyright 2016-2022, EA31337 Ltd |
+//|                                       https://github.com/EA31337 |
+//+------------------------------------------------------------------+
+
+/*
+ *  This file is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file
+ * Hashed composite key for object registries.
+ */
+
+#ifndef __MQL__
+// Allows the preprocessor to include a header file when it is needed.
+#pragma once
+#endif
+
+// Prevents processing this includes file multiple times.
+#ifndef OBJECTS_KEY_H
+#define OBJECTS_KEY_H
+
+// Defines.
+#define OBJECTS_KEY_MAX_PARTS 16  // Parts above the limit are kept as text.
+
+/**
+ * Allows to read bits of double value as an integer.
+ */
+union ObjectsKeyDoubleBits {
+  double d;
+  long l;
+};
+
+/**
+ * Composite key made of integers, doubles and strings, hashed as parts are added.
+ *
+ * String parts are kept as text (besides their hash), so keys with colliding hashes never match.
+ *
+ * Usage:
+ *
+ *   ObjectsKey _key = ObjectsKey::Make("Indi_MA", _period, (int)_ap);
+ *   _key.Add(_symbol);
+ */
+struct ObjectsKey {
+  long parts[OBJECTS_KEY_MAX_PARTS];
+  int size;
+  unsigned long hash;
+  string text;  // String parts and parts above the limit.
+
+  /**
+   * Constructor.
+   */
+  ObjectsKey() : size(0), hash(0xCBF29CE484222325), text("") {}
+
+  /* Adders */
+
+  /**
+   * Adds integer part.
+   */
+  void Add(long _value) {
+    if (size < OBJECTS_KEY_MAX_PARTS) {
+      parts[size++] = _value;
+    } else {
+      text += "#" + IntegerToString(_value);
+    }
+    // FNV-1a over the 64-bit parts.
+    hash = (hash ^ (unsigned long)_value) * 0x100000001B3;
+  }
+
+  /**
+   * Adds integer part.
+   */
+  void Add(int _value) { Add((long)_value); }
+
+  /**
+   * Adds double part (by its bits, so the value must match exactly).
+   */
+  void Add(double _value) {
+    ObjectsKeyDoubleBits _bits;
+    _bits.d = _value;
+    Add(_bits.l);
+  }
+
+  /**
+   * Adds string part (by its 64-bit hash and text).
+   */
+  void Add(string _value) {
+    unsigned long _hash = 0xCBF29CE484222325;
+    int _len = StringLen(_value);
+    for (int i = 0; i < _len; ++i) {
+      _hash = (_hash ^ StringGetCharacter(_value, i)) * 0x100000001B3;
+    }
+    // Length prefix keeps consecutive strings apart.
+    text += IntegerToString(_len) + ":" + _value;
+    Add((long)_hash);
+  }
+
+  /* Getters */
+
+  /**
+   * Checks whether keys are equal.
+   */
+  bool Equals(const ObjectsKey &_key) const {
+    if (hash != _key.hash || size != _key.size) {
+      return false;
+    }
+    for (int i = 0; i < size; ++i) {
+      if (parts[i] != _key.parts[i]) {
+        return false;
+      }
+    }
+    return text == _key.text;
+  }
+
+  /* Static methods */
+
+  template <typename A>
+  static ObjectsKey Make(A _a) {
+    ObjectsKey _key;
+    _key.Add(_a);
+    return _key;
+  }
+
+  template <typename A, typename B>
+  static ObjectsKey Make(A _a, B _b) {
+    ObjectsKey _key = Make(_a);
+    _key.Add(_b);
+    return _key;
+  }
+
+  template <typename A, typename B, typename C>
+  static ObjectsKey Make(A _a, B _b, C _c) {
+    ObjectsKey _key = Make(_a, _b);
+    _key.Add(_c);
+    return _key;
+  }
+
+  template <typename A, typename B, typename C, typename D>
+  static ObjectsKey Make(A _a, B _b, C _c, D _d) {
+    ObjectsKey _key = Make(_a, _b, _c);
+    _key.Add(_d);
+    return _key;
+  }
+
+  template <typename A, typename B, typename C, typename D, typename E>
+  static ObjectsKey Make(A _a, B _b, C _c, D _d, E _e) {
+    ObjectsKey _key = Make(_a, _b, _c, _d);
+    _key.Add(_e);
+    return _key;
+  }
+
+  template <typename A, typename B, typename C, typename D, typename E, typename F>
+  static ObjectsKey Make(A _a, B _b, C _c, D _d, E _e, F _f) {
+    ObjectsKey _key = Make(_a, _b, _c, _d, _e);
+    _key.Add(_f);
+    return _key;
+  }
+
+  template <typename A, typename B, typename C, typename D, typename E, typename F, typename G>
+  static ObjectsKey Make(A _a, B _b, C _c, D _d, E _e, F _f, G _g) {
+    ObjectsKey _key = Make(_a, _b, _c, _d, _e, _f);
+    _key.Add(_g);
+    return _key;
+  }
+
+  template <typename A, typename B, typename C, typename D, typename E, typename F, typename G, typename H>
+  static ObjectsKey Make(A _a, B _b, C _c, D _d, E _e, F _f, G _g, H _h) {
+    ObjectsKey _key = Make(_a, _b, _c, _d, _e, _f, _g);
+    _key.Add(_h);
+    return _key;
+  }
+
+  template <typename A, typename B, typename C, typename D, typename E, typename F, typename G, typename H,
+            typename I>
+  static ObjectsKey Make(A _a, B _b, C _c, D _d, E _e, F _f, G _g, H _h, I _i) {
+    ObjectsKey _key = Make(_a, _b, _c, _d, _e, _f, _g, _h);
+    _key.Add(_i);
+    return _key;
+  }
+};
+
+#endif  // OBJECTS_KEY_H
@@ -0,0 +1,158 @@
+//+------------------------------------------------------------------+
+//|                                                EA31337 framework |
+//|                                 Copyright 2016-2022, EA31337 Ltd |
+//|                                       https://github.com/EA31337 |
+//+------------------------------------------------------------------+
+
+/*
+ *  This file is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file
+ * Compact list of pivots (bar index and value) ordered by the bar index.
+ */
+
+#ifndef __MQL__
+// Allows the preprocessor to include a header file when it is needed.
+#pragma once
+#endif
+
+// Prevents processing this includes file multiple times.
+#ifndef PIVOT_LIST_H
+#define PIVOT_LIST_H
+
+// Includes.
+#include "../Refs.mqh"
+#include "../Std.h"
+
+/**
+ * Sparse replacement for the per-bar buffer of values, where most of bars have no value (e.g. ZigZag or Fractals).
+ *
+ * Pivots are added at or after the newest one, so adding costs O(1). Lookup by the bar index is a binary search.
+ */
+class PivotList : public Dynamic {
+ protected:
+  ARRAY(int, indices);    // Bar indices (0 is the oldest bar), ascending.
+  ARRAY(double, values);  // Values of pivots.
+  int count;
+
+ public:
+  /* Special methods */
+
+  /**
+   * Class constructor.
+   */
+  PivotList() : count(0) {}
+
+  /* Getters */
+
+  /**
+   * Returns number of pivots.
+   */
+  int Size() { return count; }
+
+  /**
+   * Returns bar index of the pivot at a given position.
+   */
+  int GetIndex(int _pos) { return indices[_pos]; }
+
+  /**
+   * Returns value of the pivot at a given position.
+   */
+  double GetValue(int _pos) { return values[_pos]; }
+
+  /**
+   * Returns position of the first pivot with bar index not lower than given one.
+   */
+  int LowerBound(int _index) {
+    int _lo = 0, _hi = count;
+    while (_lo < _hi) {
+      int _mid = (_lo + _hi) / 2;
+      if (indices[_mid] < _index) {
+        _lo = _mid + 1;
+      } else {
+        _hi = _mid;
+      }
+    }
+    return _lo;
+  }
+
+  /**
+   * Returns position of the pivot at a given bar index or -1 if there is no pivot.
+   */
+  int Find(int _index) {
+    int _pos = LowerBound(_index);
+    return _pos < count && indices[_pos] == _index ? _pos : -1;
+  }
+
+  /**
+   * Returns value of the pivot at a given bar index or given empty value if there is no pivot.
+   */
+  double Get(int _index, double _empty_value = 0.0) {
+    int _pos = Find(_index);
+    return _pos != -1 ? values[_pos] : _empty_value;
+  }
+
+  /* Setters */
+
+  /**
+   * Sets pivot at a given bar index. Bar index mustn't be lower than the one of the newest pivot.
+   */
+  void Set(int _index, double _value) {
+    if (count > 0 && indices[count - 1] == _index) {
+      values[count - 1] = _value;
+      return;
+    }
+    if (count >= ArraySize(indices)) {
+      ArrayResize(indices, count + 1, count + 64);
+      ArrayResize(values, count + 1, count + 64);
+    }
+    indices[count] = _index;
+    values[count] = _value;
+    ++count;
+  }
+
+  /**
+   * Removes pivot at a given bar index. Costs O(number of newer pivots).
+   */
+  void Remove(int _index) {
+    int _pos = Find(_index);
+    if (_pos == -1) {
+      return;
+    }
+    for (int i = _pos; i < count - 1; ++i) {
+      indices[i] = indices[i + 1];
+      values[i] = values[i + 1];
+    }
+    --count;
+  }
+
+  /**
+   * Replaces pivots with pivots of the other list starting from a given bar index.
+   */
+  void CopyFrom(PivotList &_list, int _from_index) {
+    count = 0;
+    for (int _pos = _list.LowerBound(_from_index); _pos < _list.Size(); ++_pos) {
+      Set(_list.GetIndex(_pos), _list.GetValue(_pos));
+    }
+  }
+
+  /**
+   * Removes all pivots.
+   */
+  void Clear() { count = 0; }
+};
+
+#endif  // PIVOT_LIST_H
@@ -0,0 +1,281 @@
+//+------------------------------------------------------------------+
+//|                                                EA31337 framework |
+//|                                 Copyright 2016-2022, EA31337 Ltd |
+//|                                       https://github.com/EA31337 |
+//+------------------------------------------------------------------+
+
+/*
+ *  This file is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file
+ * Sums of differences between consecutive values over a rolling window.
+ */
+
+#ifndef __MQL__
+// Allows the preprocessor to include a header file when it is needed.
+#pragma once
+#endif
+
+// Prevents processing this includes file multiple times.
+#ifndef ROLLING_DIFFS_H
+#define ROLLING_DIFFS_H
+
+// Includes.
+#include "../Refs.mqh"
+#include "../Std.h"
+#include "RollingStats.h"
+#include "ValueStorage.h"
+
+/**
+ * Keeps sums of rises and falls between consecutive values of the window in O(1) per value.
+ *
+ * Window of a given period holds period + 1 values, so it covers period differences. Used by adaptive moving averages
+ * (efficiency ratio of AMA, Chande Momentum Oscillator of VIDYA).
+ *
+ * Usage in the Calculate() method (differences ending at bar i are used to calculate value of the bar i):
+ *
+ *   for (i = start; i < rates_total; i++) {
+ *     _diffs.Seek(price, i + 1);
+ *     double _er = _diffs.GetEfficiencyRatio();
+ *   }
+ */
+class RollingDiffs : public Dynamic {
+ protected:
+  ARRAY(double, window);  // Ring of values in the order of adding.
+  int period;             // Number of differences.
+  int head;               // Position of the oldest value in the ring.
+  int count;              // Number of values in the window.
+  int end;                // Index (exclusive) of the last value added by Seek() or -1 if unknown.
+  int num_updates;        // Number of updates since sums have been recalculated.
+  double up_sum;          // Sum of rises.
+  double down_sum;        // Sum of falls (as positive number).
+
+  /**
+   * Returns value at a given position from the oldest one.
+   */
+  double GetValue(int _index) {
+    int _pos = head + _index;
+    return window[_pos <= period ? _pos : _pos - period - 1];
+  }
+
+  /**
+   * Adds difference to the sums.
+   */
+  void DiffAdd(double _diff) {
+    // Written without branches, as rises and falls alternate unpredictably.
+    up_sum += MathMax(_diff, 0.0);
+    down_sum += MathMax(-_diff, 0.0);
+  }
+
+  /**
+   * Removes difference from the sums.
+   */
+  void DiffRemove(double _diff) {
+    up_sum -= MathMax(_diff, 0.0);
+    down_sum -= MathMax(-_diff, 0.0);
+  }
+
+  /**
+   * Recalculates sums from the window.
+   */
+  void Resync() {
+    up_sum = 0;
+    down_sum = 0;
+    for (int i = 1; i < count; ++i) {
+      DiffAdd(GetValue(i) - GetValue(i - 1));
+    }
+  }
+
+  /**
+   * Should be called after each update of the window.
+   */
+  void OnUpdate() {
+    if (++num_updates >= ROLLING_STATS_RESYNC_PERIODS * (period + 1)) {
+      Resync();
+      num_updates = 0;
+    }
+  }
+
+ public:
+  /* Special methods */
+
+  /**
+   * Class constructor.
+   *
+   * @param _period
+   *   Number of differences in the window.
+   */
+  RollingDiffs(int _period = 1) { SetPeriod(_period); }
+
+  /* Getters */
+
+  /**
+   * Returns number of values in the window.
+   */
+  int GetCount() { return count; }
+
+  /**
+   * Returns index (exclusive) of the last value added by Seek().
+   */
+  int GetEnd() { return end; }
+
+  /**
+   * Returns number of differences in the full window.
+   */
+  int GetPeriod() { return period; }
+
+  /**
+   * Returns sum of rises.
+   */
+  double GetUpSum() { return up_sum; }
+
+  /**
+   * Returns sum of falls (as positive number).
+   */
+  double GetDownSum() { return down_sum; }
+
+  /**
+   * Returns sum of absolute differences (path length, "noise").
+   */
+  double GetAbsSum() { return up_sum + down_sum; }
+
+  /**
+   * Returns difference between the newest and the oldest value ("signal").
+   */
+  double GetNetChange() { return count > 1 ? GetValue(count - 1) - GetValue(0) : 0; }
+
+  /**
+   * Returns Kaufman's efficiency ratio: absolute net change divided by sum of absolute differences.
+   */
+  double GetEfficiencyRatio() {
+    double _noise = GetAbsSum();
+    return _noise != 0.0 ? MathAbs(GetNetChange()) / _noise : 0.0;
+  }
+
+  /**
+   * Returns Chande Momentum Oscillator in range from -1 to 1.
+   */
+  double GetCMO() {
+    double _total = up_sum + down_sum;
+    return _total != 0.0 ? (up_sum - down_sum) / _total : 0.0;
+  }
+
+  /* Setters */
+
+  /**
+   * Sets number of differences in the window. Clears the window.
+   */
+  void SetPeriod(int _period) {
+    period = _period > 0 ? _period : 1;
+    ArrayResize(window, period + 1);
+    Clear();
+  }
+
+  /* Main methods */
+
+  /**
+   * Adds value as the newest one. The oldest value is removed when window is full.
+   */
+  void Push(double _value) {
+    if (count == period + 1) {
+      DiffRemove(GetValue(1) - GetValue(0));
+      head = head < period ? head + 1 : 0;
+      --count;
+    }
+    if (count > 0) {
+      DiffAdd(_value - GetValue(count - 1));
+    }
+    int _pos = head + count;
+    window[_pos <= period ? _pos : _pos - period - 1] = _value;
+    ++count;
+    OnUpdate();
+  }
+
+  /**
+   * Removes the newest value.
+   */
+  void PopNewest() {
+    if (count == 0) {
+      return;
+    }
+    if (count > 1) {
+      DiffRemove(GetValue(count - 1) - GetValue(count - 2));
+    }
+    --count;
+    OnUpdate();
+  }
+
+  /**
+   * Adds value as the oldest one. Window mustn't be full.
+   */
+  void PushOldest(double _value) {
+    if (count == period + 1) {
+      return;
+    }
+    if (count > 0) {
+      DiffAdd(GetValue(0) - _value);
+    }
+    head = head > 0 ? head - 1 : period;
+    window[head] = _value;
+    ++count;
+    OnUpdate();
+  }
+
+  /**
+   * Moves window to end (exclusively) at given index of values.
+   *
+   * Moving by one value forward or backward, or refreshing the newest value (e.g. to recalculate the current bar) costs
+   * O(1). Otherwise window is rebuilt from the values.
+   */
+  void Seek(ValueStorage<double> &_values, int _end) {
+    if (_end == end) {
+      if (count > 0 && GetValue(count - 1) != _values[end - 1].Get()) {
+        // The newest value (e.g. the current bar) has changed since.
+        PopNewest();
+        Push(_values[end - 1].Get());
+      }
+      return;
+    }
+    if (end > 0 && _end == end + 1) {
+      Push(_values[end].Get());
+    } else if (end > 0 && _end == end - 1) {
+      PopNewest();
+      if (_end - period - 1 >= 0) {
+        PushOldest(_values[_end - period - 1].Get());
+      }
+    } else {
+      Clear();
+      for (int i = MathMax(0, _end - period - 1); i < _end; ++i) {
+        Push(_values[i].Get());
+      }
+    }
+    end = _end;
+  }
+
+  /**
+   * Removes all values.
+   */
+  void Clear() {
+    head = 0;
+    count = 0;
+    end = -1;
+    num_updates = 0;
+    up_sum = 0;
+    down_sum = 0;
+  }
+};
+
+#endif  // ROLLING_DIFFS_H
@@ -0,0 +1,195 @@
+//+------------------------------------------------------------------+
+//|                                                EA31337 framework |
+//|                                 Copyright 2016-2022, EA31337 Ltd |
+//|                                       https://github.com/EA31337 |
+//+------------------------------------------------------------------+
+
+/*
+ *  This file is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file
+ * Highest or lowest value over a rolling window.
+ */
+
+#ifndef __MQL__
+// Allows the preprocessor to include a header file when it is needed.
+#pragma once
+#endif
+
+// Prevents processing this includes file multiple times.
+#ifndef ROLLING_PEAK_H
+#define ROLLING_PEAK_H
+
+// Includes.
+#include "../Refs.mqh"
+#include "../Std.h"
+#include "ValueStorage.h"
+
+/**
+ * Keeps the highest or the lowest value of the window in amortized O(1) per value (monotonic deque).
+ *
+ * Only values which may still become the peak are kept, ordered from the oldest one (the current peak). Replaces
+ * iHighest()/iLowest() rescans of the whole window for each bar.
+ *
+ * Usage in the Calculate() method (window ending at bar i is used to calculate value of the bar i):
+ *
+ *   for (i = start; i < rates_total; i++) {
+ *     _highest.Seek(high, i + 1);
+ *     double _hi = _highest.GetPeak();
+ *   }
+ */
+class RollingPeak : public Dynamic {
+ protected:
+  ARRAY(double, values);  // Ring of candidates for the peak.
+  ARRAY(int, indices);    // Indices of candidates in the values.
+  ENUM_IPEAK type;
+  int period;
+  int head;   // Position of the oldest candidate (the peak) in the ring.
+  int count;  // Number of candidates.
+  int end;    // Index (exclusive) of the last value added by Seek() or -1 if unknown.
+
+  /**
+   * Checks whether newer value makes older value obsolete.
+   */
+  bool Supersedes(double _newer, double _older) {
+    return type == IPEAK_HIGHEST ? _newer >= _older : _newer <= _older;
+  }
+
+  /**
+   * Adds value at a given index as the newest one.
+   */
+  void Add(int _index, double _value) {
+    // Candidates out of the window.
+    while (count > 0 && indices[head] <= _index - period) {
+      head = (head + 1) % period;
+      --count;
+    }
+    // Candidates which can't be the peak anymore.
+    while (count > 0 && Supersedes(_value, values[(head + count - 1) % period])) {
+      --count;
+    }
+    int _pos = (head + count) % period;
+    values[_pos] = _value;
+    indices[_pos] = _index;
+    ++count;
+  }
+
+ public:
+  /* Special methods */
+
+  /**
+   * Class constructor.
+   */
+  RollingPeak(int _period = 1, ENUM_IPEAK _type = IPEAK_HIGHEST) : type(_type) { SetPeriod(_period); }
+
+  /* Getters */
+
+  /**
+   * Returns number of candidates for the peak (0 when window is empty).
+   */
+  int GetCount() { return count; }
+
+  /**
+   * Returns index (exclusive) of the last value added by Seek() or Push().
+   */
+  int GetEnd() { return end; }
+
+  /**
+   * Returns window's length.
+   */
+  int GetPeriod() { return period; }
+
+  /**
+   * Returns the highest or the lowest value of the window.
+   */
+  double GetPeak() { return count > 0 ? values[head] : 0; }
+
+  /**
+   * Returns index of the peak in the values or -1 if window is empty.
+   */
+  int GetPeakIndex() { return count > 0 ? indices[head] : -1; }
+
+  /**
+   * Returns type of the peak.
+   */
+  ENUM_IPEAK GetType() { return type; }
+
+  /* Setters */
+
+  /**
+   * Sets window's length. Clears the window.
+   */
+  void SetPeriod(int _period) {
+    period = _period > 0 ? _period : 1;
+    ArrayResize(values, period);
+    ArrayResize(indices, period);
+    Clear();
+  }
+
+  /**
+   * Sets type of the peak. Clears the window.
+   */
+  void SetType(ENUM_IPEAK _type) {
+    type = _type;
+    Clear();
+  }
+
+  /* Main methods */
+
+  /**
+   * Adds value as the newest one. Used instead of Seek() when values are streamed one by one.
+   */
+  void Push(double _value) {
+    int _index = end < 0 ? 0 : end;
+    Add(_index, _value);
+    end = _index + 1;
+  }
+
+  /**
+   * Moves window to end (exclusively) at given index of values.
+   *
+   * Moving forward by one value costs amortized O(1). Otherwise (including change of the newest value, e.g. to
+   * recalculate the current bar) window is rebuilt from the values.
+   */
+  void Seek(ValueStorage<double> &_values, int _end) {
+    if (_end == end) {
+      // The newest value is always a candidate.
+      if (count == 0 || values[(head + count - 1) % period] == _values[end - 1].Get()) {
+        return;
+      }
+    } else if (end > 0 && _end == end + 1) {
+      Add(end, _values[end].Get());
+      end = _end;
+      return;
+    }
+    Clear();
+    for (int i = MathMax(0, _end - period); i < _end; ++i) {
+      Add(i, _values[i].Get());
+    }
+    end = _end;
+  }
+
+  /**
+   * Removes all values.
+   */
+  void Clear() {
+    head = 0;
+    count = 0;
+    end = -1;
+  }
+};
+
+#endif  // ROLLING_PEAK_H
@@ -0,0 +1,379 @@
+//+------------------------------------------------------------------+
+//|                                                EA31337 framework |
+//|                                 Copyright 2016-2022, EA31337 Ltd |
+//|                                       https://github.com/EA31337 |
+//+------------------------------------------------------------------+
+
+/*
+ *  This file is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file
+ * Statistics over a rolling window of values.
+ */
+
+#ifndef __MQL__
+// Allows the preprocessor to include a header file when it is needed.
+#pragma once
+#endif
+
+// Prevents processing this includes file multiple times.
+#ifndef ROLLING_STATS_H
+#define ROLLING_STATS_H
+
+// Includes.
+#include "../Refs.mqh"
+#include "../Std.h"
+#include "ValueStorage.h"
+
+// Defines.
+#define ROLLING_STATS_RESYNC_PERIODS 64  // Running sums are recalculated after given number of window's periods.
+
+/**
+ * Keeps statistics of the last values in O(1) per value.
+ *
+ * Mean absolute deviation needs the window sorted. Position of the value is found by binary search, but inserting or
+ * removing it shifts the sorted array, so each value costs O(period) copies.
+ *
+ * Variance uses Welford's algorithm which is numerically stable on adding and removing values. Running sums are
+ * recalculated from the window from time to time, so rounding errors don't accumulate.
+ *
+ * Usage in the Calculate() method (window ending at bar i is used to calculate value of the bar i):
+ *
+ *   for (i = start; i < rates_total; i++) {
+ *     _stats.Seek(price, i + 1);
+ *     StdDevBuffer[i] = _stats.GetStdDev();
+ *   }
+ */
+class RollingStats : public Dynamic {
+ protected:
+  ARRAY(double, window);  // Ring of values in the order of adding.
+  ARRAY(double, sorted);  // Values sorted ascending. Used only for mean absolute deviation.
+  int period;
+  int head;                   // Position of the oldest value in the ring.
+  int count;                  // Number of values in the window.
+  int end;                    // Index (exclusive) of the last value added by Seek() or -1 if unknown.
+  int num_updates;            // Number of updates since running sums have been recalculated.
+  bool track_mad;             // Whether to keep sorted window for mean absolute deviation.
+  double mean, m2;            // Welford's mean and sum of squared differences from the mean.
+  double sum, weighted_sum;   // Sum and linearly weighted sum (the newest value has weight of count).
+  double split_mean;          // Mean which split sorted values into lower and upper part.
+  int split;                  // Number of sorted values lower than split_mean.
+  double split_sum;           // Sum of sorted values lower than split_mean.
+
+  /**
+   * Returns position of the first sorted value not lower than given one.
+   */
+  int LowerBound(double _value) {
+    int _lo = 0, _hi = count;
+    while (_lo < _hi) {
+      int _mid = (_lo + _hi) / 2;
+      if (sorted[_mid] < _value) {
+        _lo = _mid + 1;
+      } else {
+        _hi = _mid;
+      }
+    }
+    return _lo;
+  }
+
+  /**
+   * Inserts value into sorted values in O(period). Should be called before count is updated.
+   */
+  void SortedInsert(double _value) {
+    int _pos = LowerBound(_value);
+    for (int i = count; i > _pos; --i) {
+      sorted[i] = sorted[i - 1];
+    }
+    sorted[_pos] = _value;
+    if (_value < split_mean) {
+      ++split;
+      split_sum += _value;
+    }
+  }
+
+  /**
+   * Removes value from sorted values in O(period). Should be called before count is updated.
+   */
+  void SortedRemove(double _value) {
+    int _pos = LowerBound(_value);
+    for (int i = _pos; i < count - 1; ++i) {
+      sorted[i] = sorted[i + 1];
+    }
+    if (_value < split_mean) {
+      --split;
+      split_sum -= _value;
+    }
+  }
+
+  /**
+   * Welford's update for added value.
+   */
+  void StatsAdd(double _value) {
+    double _delta = _value - mean;
+    mean += _delta / count;
+    m2 += _delta * (_value - mean);
+  }
+
+  /**
+   * Welford's update for removed value.
+   */
+  void StatsRemove(double _value) {
+    if (count == 0) {
+      mean = 0;
+      m2 = 0;
+      return;
+    }
+    double _delta = _value - mean;
+    mean -= _delta / count;
+    m2 -= _delta * (_value - mean);
+  }
+
+  /**
+   * Recalculates running sums from the window.
+   */
+  void Resync() {
+    double _mean = 0, _m2 = 0, _sum = 0, _weighted_sum = 0;
+    for (int i = 0; i < count; ++i) {
+      double _value = window[(head + i) % period];
+      double _delta = _value - _mean;
+      _mean += _delta / (i + 1);
+      _m2 += _delta * (_value - _mean);
+      _sum += _value;
+      _weighted_sum += (i + 1) * _value;
+    }
+    mean = _mean;
+    m2 = _m2;
+    sum = _sum;
+    weighted_sum = _weighted_sum;
+    if (track_mad) {
+      split_sum = 0;
+      for (int i = 0; i < split; ++i) {
+        split_sum += sorted[i];
+      }
+    }
+    num_updates = 0;
+  }
+
+  /**
+   * Counts update and recalculates running sums when needed.
+   */
+  void OnUpdate() {
+    if (++num_updates >= period * ROLLING_STATS_RESYNC_PERIODS) {
+      Resync();
+    }
+  }
+
+ public:
+  /**
+   * Constructor.
+   *
+   * @param _track_mad
+   *   Whether to keep sorted window in order to calculate mean absolute deviation.
+   */
+  RollingStats(int _period = 1, bool _track_mad = false) : track_mad(_track_mad) { SetPeriod(_period); }
+
+  /* Getters */
+
+  /**
+   * Returns number of values in the window.
+   */
+  int GetCount() { return count; }
+
+  /**
+   * Returns index (exclusive) of the last value added by Seek().
+   */
+  int GetEnd() { return end; }
+
+  /**
+   * Returns mean of the window.
+   */
+  double GetMean() { return mean; }
+
+  /**
+   * Returns linearly weighted mean of the window (the oldest value has weight of 1).
+   */
+  double GetLinearWeightedMean() { return count > 0 ? weighted_sum / (count * (count + 1) / 2.0) : 0; }
+
+  /**
+   * Returns window's length.
+   */
+  int GetPeriod() { return period; }
+
+  /**
+   * Returns population variance of the window.
+   */
+  double GetVariance() { return count > 0 && m2 > 0 ? m2 / count : 0; }
+
+  /**
+   * Returns population standard deviation of the window.
+   */
+  double GetStdDev() { return MathSqrt(GetVariance()); }
+
+  /**
+   * Returns population standard deviation from the given value (e.g. moving average other than the simple one).
+   */
+  double GetStdDev(double _center) {
+    return count > 0 ? MathSqrt(GetVariance() + (mean - _center) * (mean - _center)) : 0;
+  }
+
+  /**
+   * Returns mean absolute deviation from the mean. Requires _track_mad to be set in the constructor.
+   */
+  double GetMeanAbsDev() {
+    if (count == 0) {
+      return 0;
+    }
+    // Moving split to the current mean. Mean moves slowly, so only few values cross it.
+    while (split < count && sorted[split] < mean) {
+      split_sum += sorted[split++];
+    }
+    while (split > 0 && sorted[split - 1] >= mean) {
+      split_sum -= sorted[--split];
+    }
+    split_mean = mean;
+    // Sum of |x - mean| is (mean * lower - sum of lower) + (sum of upper - mean * upper) = 2 * (mean * lower - sum of
+    // lower), as sum of all values equals mean * count.
+    return MathMax(0.0, 2 * (mean * split - split_sum) / count);
+  }
+
+  /* Setters */
+
+  /**
+   * Sets window's length. Clears the window.
+   */
+  void SetPeriod(int _period) {
+    period = _period > 0 ? _period : 1;
+    ArrayResize(window, period);
+    ArrayResize(sorted, track_mad ? period : 0);
+    Clear();
+  }
+
+  /* Main methods */
+
+  /**
+   * Adds value as the newest one. Removes the oldest value if window is full.
+   */
+  void Push(double _value) {
+    if (count == period) {
+      double _oldest = window[head];
+      if (track_mad) {
+        SortedRemove(_oldest);
+      }
+      head = (head + 1) % period;
+      --count;
+      StatsRemove(_oldest);
+      weighted_sum -= sum;
+      sum -= _oldest;
+    }
+    if (track_mad) {
+      SortedInsert(_value);
+    }
+    window[(head + count) % period] = _value;
+    ++count;
+    StatsAdd(_value);
+    sum += _value;
+    weighted_sum += count * _value;
+    OnUpdate();
+  }
+
+  /**
+   * Removes the newest value.
+   */
+  void PopNewest() {
+    if (count == 0) {
+      return;
+    }
+    double _newest = window[(head + count - 1) % period];
+    if (track_mad) {
+      SortedRemove(_newest);
+    }
+    weighted_sum -= count * _newest;
+    sum -= _newest;
+    --count;
+    StatsRemove(_newest);
+    OnUpdate();
+  }
+
+  /**
+   * Adds value as the oldest one. Window mustn't be full.
+   */
+  void PushOldest(double _value) {
+    if (count == period) {
+      return;
+    }
+    if (track_mad) {
+      SortedInsert(_value);
+    }
+    head = (head - 1 + period) % period;
+    window[head] = _value;
+    ++count;
+    StatsAdd(_value);
+    // Weights of all values are increased by one.
+    weighted_sum += sum + _value;
+    sum += _value;
+    OnUpdate();
+  }
+
+  /**
+   * Moves window to end (exclusively) at given index of values.
+   *
+   * Moving by one value forward or backward, or refreshing the newest value (e.g. to recalculate the current bar) costs
+   * O(1). Otherwise window is rebuilt from the values.
+   */
+  void Seek(ValueStorage<double> &_values, int _end) {
+    if (_end == end) {
+      if (count > 0 && window[(head + count - 1) % period] != _values[end - 1].Get()) {
+        // The newest value (e.g. the current bar) has changed since.
+        PopNewest();
+        Push(_values[end - 1].Get());
+      }
+      return;
+    }
+    if (end > 0 && _end == end + 1) {
+      Push(_values[end].Get());
+    } else if (end > 0 && _end == end - 1) {
+      PopNewest();
+      if (_end - period >= 0) {
+        PushOldest(_values[_end - period].Get());
+      }
+    } else {
+      Clear();
+      for (int i = MathMax(0, _end - period); i < _end; ++i) {
+        Push(_values[i].Get());
+      }
+    }
+    end = _end;
+  }
+
+  /**
+   * Removes all values.
+   */
+  void Clear() {
+    head = 0;
+    count = 0;
+    end = -1;
+    num_updates = 0;
+    mean = 0;
+    m2 = 0;
+    sum = 0;
+    weighted_sum = 0;
+    split_mean = 0;
+    split = 0;
+    split_sum = 0;
+  }
+};
+
+#endif  // ROLLING_STATS_H
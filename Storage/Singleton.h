@@ -44,7 +44,12 @@ class Singleton {
   static C* Get() { return &_ref; }
 };
 
+#ifdef __MQL__
 template <typename C>
 C Singleton::_ref;
+#else
+template <typename C>
+C Singleton<C>::_ref;
+#endif
 
 #endif  // SINGLETON_H
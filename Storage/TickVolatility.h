@@ -0,0 +1,252 @@
+//+------------------------------------------------------------------+
+//|                                                EA31337 framework |
+//|                                 Copyright 2016-2022, EA31337 Ltd |
+//|                                       https://github.com/EA31337 |
+//+------------------------------------------------------------------+
+
+/*
+ *  This file is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file
+ * Tick-level volatility estimators with time-decay weights.
+ */
+
+#ifndef __MQL__
+// Allows the preprocessor to include a header file when it is needed.
+#pragma once
+#endif
+
+// Prevents processing this includes file multiple times.
+#ifndef TICK_VOLATILITY_H
+#define TICK_VOLATILITY_H
+
+// Includes.
+#include "../Math.extern.h"
+#include "../Refs.mqh"
+#include "../Std.h"
+
+// Estimated values.
+enum ENUM_TICK_VOLATILITY_MODE {
+  TICK_VOLATILITY_MODE_EWMA_VAR,      // EWMA variance of tick log returns.
+  TICK_VOLATILITY_MODE_REALIZED_VOL,  // Realized volatility of the recent decay period.
+  TICK_VOLATILITY_MODE_PARKINSON,     // Parkinson volatility of bucket's OHLC.
+  TICK_VOLATILITY_MODE_GARMAN_KLASS,  // Garman-Klass volatility of bucket's OHLC.
+  TICK_VOLATILITY_MODE_TICK_RATE,     // Ticks per second.
+  FINAL_TICK_VOLATILITY_MODE_ENTRY
+};
+
+/**
+ * Volatility estimated from ticks, without building candles first.
+ *
+ * Every sum is multiplied by exp(-dt / decay) when tick comes dt seconds after
+ * the previous one, so each tick costs O(1) and the recent decay period weights
+ * the most. Ticks with the same timestamp get equal weights.
+ *
+ * Parkinson and Garman-Klass estimators are calculated from OHLC of buckets of
+ * a fixed number of seconds. Completed buckets are weighted the same way, so
+ * their values are volatility per bucket.
+ *
+ * Ratios of decayed sums don't change between ticks. Realized volatility and
+ * tick rate do, so they can be decayed to the given query time.
+ */
+class TickVolatility {
+ protected:
+  double decay;     // Decay period in seconds.
+  int bucket_secs;  // Length of OHLC bucket in seconds.
+  long last_time;
+  double last_price;
+  unsigned long num_ticks;
+  // Decayed sums.
+  double sum_ticks;      // Number of ticks.
+  double sum_returns;    // Number of returns.
+  double sum_sq_returns;  // Squared log returns.
+  double sum_buckets;    // Number of completed buckets.
+  double sum_parkinson;  // Parkinson variances of completed buckets.
+  double sum_gk;         // Garman-Klass variances of completed buckets.
+  // Current bucket.
+  long bucket_time;
+  double bucket_open, bucket_high, bucket_low, bucket_close;
+
+  /**
+   * Adds completed bucket's variances.
+   */
+  void CloseBucket() {
+    if (bucket_low <= 0 || bucket_open <= 0) {
+      return;
+    }
+    double _hl = MathLog(bucket_high / bucket_low);
+    double _co = MathLog(bucket_close / bucket_open);
+    sum_parkinson += _hl * _hl / (4 * MathLog(2.0));
+    sum_gk += 0.5 * _hl * _hl - (2 * MathLog(2.0) - 1) * _co * _co;
+    sum_buckets += 1;
+  }
+
+  /**
+   * Returns square root of given sum divided by given weight, or 0 if there is no weight.
+   */
+  static double SqrtRatio(double _sum, double _weight) {
+    return _weight > 0 && _sum > 0 ? MathSqrt(_sum / _weight) : 0;
+  }
+
+  /**
+   * Returns weight of the last tick at a given time (1 if time isn't after the last tick).
+   */
+  double GetWeight(long _time) { return _time > last_time ? MathExp(-(double)(_time - last_time) / decay) : 1; }
+
+ public:
+  /* Special methods */
+
+  /**
+   * Class constructor.
+   *
+   * @param _decay
+   *   Decay period in seconds. Weight of a tick drops to 1/e after that time.
+   * @param _bucket_secs
+   *   Length of bucket used by OHLC-based estimators.
+   */
+  TickVolatility(double _decay = 300, int _bucket_secs = 60)
+      : decay(_decay > 0 ? _decay : 1), bucket_secs(_bucket_secs > 0 ? _bucket_secs : 1) {
+    Clear();
+  }
+
+  /* Getters */
+
+  /**
+   * Returns decay period in seconds.
+   */
+  double GetDecay() { return decay; }
+
+  /**
+   * Returns length of OHLC bucket in seconds.
+   */
+  int GetBucketSecs() { return bucket_secs; }
+
+  /**
+   * Returns number of processed ticks.
+   */
+  unsigned long GetNumTicks() { return num_ticks; }
+
+  /**
+   * Returns EWMA variance of tick log returns.
+   */
+  double GetEwmaVariance() { return sum_returns > 0 ? sum_sq_returns / sum_returns : 0; }
+
+  /**
+   * Returns realized volatility, i.e. square root of decayed sum of squared log returns.
+   *
+   * @param _time
+   *   Time to decay the sum to. Value is as of the last tick when time is 0.
+   */
+  double GetRealizedVolatility(long _time = 0) {
+    return sum_sq_returns > 0 ? MathSqrt(sum_sq_returns * GetWeight(_time)) : 0;
+  }
+
+  /**
+   * Returns Parkinson volatility per bucket.
+   */
+  double GetParkinson() { return SqrtRatio(sum_parkinson, sum_buckets); }
+
+  /**
+   * Returns Garman-Klass volatility per bucket.
+   */
+  double GetGarmanKlass() { return SqrtRatio(sum_gk, sum_buckets); }
+
+  /**
+   * Returns number of ticks per second.
+   *
+   * @param _time
+   *   Time to decay the rate to. Value is as of the last tick when time is 0.
+   */
+  double GetTickRate(long _time = 0) { return sum_ticks * GetWeight(_time) / decay; }
+
+  /**
+   * Returns estimated value of a given mode.
+   *
+   * @param _time
+   *   Time to decay time-dependent values to. Values are as of the last tick when time is 0.
+   */
+  double Get(ENUM_TICK_VOLATILITY_MODE _mode, long _time = 0) {
+    switch (_mode) {
+      case TICK_VOLATILITY_MODE_EWMA_VAR:
+        return GetEwmaVariance();
+      case TICK_VOLATILITY_MODE_REALIZED_VOL:
+        return GetRealizedVolatility(_time);
+      case TICK_VOLATILITY_MODE_PARKINSON:
+        return GetParkinson();
+      case TICK_VOLATILITY_MODE_GARMAN_KLASS:
+        return GetGarmanKlass();
+      case TICK_VOLATILITY_MODE_TICK_RATE:
+        return GetTickRate(_time);
+    }
+    return EMPTY_VALUE;
+  }
+
+  /* Main methods */
+
+  /**
+   * Processes a single tick.
+   *
+   * @param _time
+   *   Tick's time in seconds. Late ticks are treated as coming at the time of the previous tick.
+   */
+  void Update(long _time, double _price) {
+    if (_price <= 0) {
+      return;
+    }
+    if (num_ticks > 0) {
+      double _weight = GetWeight(_time);
+      sum_ticks *= _weight;
+      sum_returns *= _weight;
+      sum_sq_returns *= _weight;
+      sum_buckets *= _weight;
+      sum_parkinson *= _weight;
+      sum_gk *= _weight;
+      double _return = MathLog(_price / last_price);
+      sum_returns += 1;
+      sum_sq_returns += _return * _return;
+    }
+    long _bucket_time = _time - _time % bucket_secs;
+    if (num_ticks == 0 || _bucket_time > bucket_time) {
+      if (num_ticks > 0) {
+        CloseBucket();
+      }
+      bucket_time = _bucket_time;
+      bucket_open = bucket_high = bucket_low = _price;
+    }
+    bucket_high = MathMax(bucket_high, _price);
+    bucket_low = MathMin(bucket_low, _price);
+    bucket_close = _price;
+    sum_ticks += 1;
+    last_time = _time > last_time ? _time : last_time;
+    last_price = _price;
+    ++num_ticks;
+  }
+
+  /**
+   * Resets all estimators.
+   */
+  void Clear() {
+    last_time = 0;
+    last_price = 0;
+    num_ticks = 0;
+    sum_ticks = sum_returns = sum_sq_returns = 0;
+    sum_buckets = sum_parkinson = sum_gk = 0;
+    bucket_time = 0;
+    bucket_open = bucket_high = bucket_low = bucket_close = 0;
+  }
+};
+
+#endif  // TICK_VOLATILITY_H
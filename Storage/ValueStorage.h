@@ -35,6 +35,7 @@
 
 // Includes.
 #include "Objects.h"
+#include "ObjectsByKey.h"
 
 // Enumeration for iPeak().
 enum ENUM_IPEAK { IPEAK_LOWEST, IPEAK_HIGHEST };
@@ -43,6 +44,25 @@ enum ENUM_IPEAK { IPEAK_LOWEST, IPEAK_HIGHEST };
 #define INDICATOR_BUFFER_VALUE_STORAGE_HISTORY \
   300  // Number of entries the value storage buffer will be initialized with.
 
+#ifndef INDICATOR_CALCULATE_CACHE_MAX_SIZE
+// Maximum number of calculation caches kept at once, the least recently used ones are evicted.
+#define INDICATOR_CALCULATE_CACHE_MAX_SIZE 1000
+#endif
+
+#ifdef __indicator_snapshots__
+// Restores newly created cache from the snapshot file, so calculation resumes from the last saved bar.
+// Snapshot is keyed on the identity of the source indicator (SOURCE_ID), which stays the same between runs.
+#define INDICATOR_CALCULATE_RESTORE_CACHE(CACHE, SYMBOL, TF, KEY, SOURCE_ID)                         \
+  ObjectsKey _snapshot_key = KEY;                                                                    \
+  _snapshot_key.Add(SYMBOL);                                                                         \
+  _snapshot_key.Add((int)TF);                                                                        \
+  _snapshot_key.Add((long)(SOURCE_ID));                                                              \
+  CACHE PTR_DEREF SetTimeBuffer(TimeValueStorage::GetInstance(SYMBOL, TF));                          \
+  CACHE PTR_DEREF LoadSnapshot(IndicatorCalculateCache<double>::GetSnapshotFileName(_snapshot_key));
+#else
+#define INDICATOR_CALCULATE_RESTORE_CACHE(CACHE, SYMBOL, TF, KEY, SOURCE_ID)
+#endif
+
 #define INDICATOR_CALCULATE_PARAMS_LONG                                                                                \
   ValueStorage<datetime> &_time, ValueStorage<double> &_open, ValueStorage<double> &_high, ValueStorage<double> &_low, \
       ValueStorage<double> &_close, ValueStorage<long> &_tick_volume, ValueStorage<long> &_volume,                     \
@@ -65,12 +85,29 @@ enum ENUM_IPEAK { IPEAK_LOWEST, IPEAK_HIGHEST };
 
 #define INDICATOR_CALCULATE_GET_PARAMS_SHORT _cache.GetTotal(), _cache.GetPrevCalculated(), 0, _cache.GetPriceBuffer()
 
-#define INDICATOR_CALCULATE_POPULATE_CACHE(SYMBOL, TF, KEY)                                              \
-  IndicatorCalculateCache<double> *_cache;                                                               \
-  string _key = Util::MakeKey(SYMBOL, (int)TF, KEY);                                                     \
-  if (!Objects<IndicatorCalculateCache<double>>::TryGet(_key, _cache)) {                                 \
-    _cache = Objects<IndicatorCalculateCache<double>>::Set(_key, new IndicatorCalculateCache<double>()); \
-  }
+#define INDICATOR_CALCULATE_POPULATE_CACHE(SYMBOL, TF, KEY) \
+  INDICATOR_CALCULATE_POPULATE_CACHE_SOURCE(SYMBOL, TF, KEY, 0, 0)
+
+// Cache of the calculation on the source indicator is kept per source instance (INSTANCE_ID),
+// while its snapshot is kept per source identity (SOURCE_ID).
+#define INDICATOR_CALCULATE_POPULATE_CACHE_SOURCE(SYMBOL, TF, KEY, INSTANCE_ID, SOURCE_ID) \
+  IndicatorCalculateCache<double> *_cache;                                                 \
+  ObjectsByKey<IndicatorCalculateCache<double>> *_caches =                                 \
+      ObjectsByKey<IndicatorCalculateCache<double>>::GetInstance();                        \
+  ObjectsKey _key = KEY;                                                                   \
+  _key.Add(SYMBOL);                                                                        \
+  _key.Add((int)TF);                                                                       \
+  _key.Add((long)(INSTANCE_ID));                                                           \
+  if (!_caches PTR_DEREF TryGet(_key, _cache)) {                                           \
+    _caches PTR_DEREF SetMaxSize(INDICATOR_CALCULATE_CACHE_MAX_SIZE);                      \
+    _cache = _caches PTR_DEREF Set(_key, new IndicatorCalculateCache<double>());           \
+    INDICATOR_CALCULATE_RESTORE_CACHE(_cache, SYMBOL, TF, KEY, SOURCE_ID)                  \
+  }                                                                                        \
+  /* Nested calculations mustn't evict the cache while it is in use. */                    \
+  ObjectsByKeyPin<IndicatorCalculateCache<double>> _cache_pin(_caches, _key);
+
+#define INDICATOR_CALCULATE_POPULATE_CACHE_DS(INDI, SYMBOL, TF, KEY) \
+  INDICATOR_CALCULATE_POPULATE_CACHE_SOURCE(SYMBOL, TF, KEY, INDI.GetInstanceId(), INDI.GetIdentityKey().hash)
 
 #define INDICATOR_CALCULATE_POPULATE_PARAMS_AND_CACHE_LONG(SYMBOL, TF, KEY)                     \
   ValueStorage<datetime> *_time = TimeValueStorage::GetInstance(SYMBOL, TF);                    \
@@ -89,7 +126,7 @@ enum ENUM_IPEAK { IPEAK_LOWEST, IPEAK_HIGHEST };
 
 #define INDICATOR_CALCULATE_POPULATE_PARAMS_AND_CACHE_SHORT_DS(INDI, SYMBOL, TF, APPLIED_PRICE, KEY) \
   ValueStorage<double> *_price = INDI.GetValueStorage(APPLIED_PRICE);                                \
-  INDICATOR_CALCULATE_POPULATE_CACHE(SYMBOL, TF, KEY)
+  INDICATOR_CALCULATE_POPULATE_CACHE_DS(INDI, SYMBOL, TF, KEY)
 
 #define INDICATOR_CALCULATE_POPULATE_PARAMS_AND_CACHE_SHORT_DS_SPECIFIC(INDI, SYMBOL, TF, APPLIED_PRICE, KEY)         \
   ValueStorage<double> *_price;                                                                                       \
@@ -102,7 +139,7 @@ enum ENUM_IPEAK { IPEAK_LOWEST, IPEAK_HIGHEST };
     DebugBreak();                                                                                                     \
   }                                                                                                                   \
                                                                                                                       \
-  INDICATOR_CALCULATE_POPULATE_CACHE(SYMBOL, TF, KEY)
+  INDICATOR_CALCULATE_POPULATE_CACHE_DS(INDI, SYMBOL, TF, KEY)
 
 #define INDICATOR_CALCULATE_POPULATE_PARAMS_AND_CACHE_LONG_DS(INDI, SYMBOL, TF, KEY)                                   \
   ValueStorage<datetime> *_time = (ValueStorage<datetime> *)INDI.GetSpecificValueStorage(INDI_VS_TYPE_TIME);           \
@@ -113,7 +150,7 @@ enum ENUM_IPEAK { IPEAK_LOWEST, IPEAK_HIGHEST };
   ValueStorage<double> *_price_high = (ValueStorage<double> *)INDI.GetSpecificValueStorage(INDI_VS_TYPE_PRICE_HIGH);   \
   ValueStorage<double> *_price_low = (ValueStorage<double> *)INDI.GetSpecificValueStorage(INDI_VS_TYPE_PRICE_LOW);     \
   ValueStorage<double> *_price_close = (ValueStorage<double> *)INDI.GetSpecificValueStorage(INDI_VS_TYPE_PRICE_CLOSE); \
-  INDICATOR_CALCULATE_POPULATE_CACHE(SYMBOL, TF, KEY)
+  INDICATOR_CALCULATE_POPULATE_CACHE_DS(INDI, SYMBOL, TF, KEY)
 
 #define INDICATOR_CALCULATE_POPULATED_PARAMS_LONG \
   _time, _price_open, _price_high, _price_low, _price_close, _tick_volume, _volume, _spread
@@ -96,4 +96,36 @@ class NativeValueStorage : public ValueStorage<C> {
     ArraySetAsSeries(_values, _value);
     return true;
   }
+
+  /* Snapshot methods */
+
+  /**
+   * Writes values into the binary file.
+   */
+  bool Save(int _handle) {
+    int _size = ArraySize(_values);
+    bool _is_series = IsSeries();
+    FileWriteInteger(_handle, _size);
+    FileWriteInteger(_handle, _is_series ? 1 : 0);
+    // Values are always written in the order of the memory.
+    ArraySetAsSeries(_values, false);
+    bool _result = _size == 0 || FileWriteArray(_handle, _values, 0, _size) == (unsigned int)_size;
+    ArraySetAsSeries(_values, _is_series);
+    return _result;
+  }
+
+  /**
+   * Reads values written by Save().
+   */
+  bool Load(int _handle) {
+    int _size = FileReadInteger(_handle);
+    bool _is_series = FileReadInteger(_handle) != 0;
+    if (_size < 0) {
+      return false;
+    }
+    ArraySetAsSeries(_values, false);
+    ArrayResize(_values, _size, 4096);
+    ArraySetAsSeries(_values, _is_series);
+    return _size == 0 || FileReadArray(_handle, _values, 0, _size) == (unsigned int)_size;
+  }
 };
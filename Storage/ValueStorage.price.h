@@ -24,6 +24,15 @@
  * Price getter version of ValueStorage.
  */
 
+#ifndef __MQL__
+// Allows the preprocessor to include a header file when it is needed.
+#pragma once
+#endif
+
+// Prevents processing this includes file multiple times.
+#ifndef VALUE_STORAGE_PRICE_H
+#define VALUE_STORAGE_PRICE_H
+
 // Includes.
 #include "../Chart.struct.h"
 #include "ObjectsCache.h"
@@ -31,29 +40,160 @@
 
 /**
  * Storage to retrieve OHLC.
+ *
+ * Instances returned by GetInstance() are shared by all indicators using the same symbol, time-frame and applied
+ * price. Applied prices of completed bars are calculated once per new bar and kept in the native array, only the
+ * current bar is fetched from the chart on each call.
  */
 class PriceValueStorage : public HistoryValueStorage<double> {
-  // Time-frame to fetch price for.
+  // Applied price to fetch.
   ENUM_APPLIED_PRICE ap;
 
+  // Applied prices of completed bars (the oldest bar first).
+  ARRAY(double, values);
+
+  // Number of bars at the last update.
+  int num_bars;
+
+  // Time of the current bar at the last update.
+  datetime last_bar_time;
+
+  // Time of the newest bar in the values.
+  datetime values_end_time;
+
+  // Statistics of all instances.
+  static int stats_num_instances;
+  static long stats_num_values;
+  static long stats_num_fetches_stored;
+  static long stats_num_fetches_live;
+  static long stats_num_updates;
+  static long stats_num_requests;
+
+  /**
+   * Initializes storage and its statistics.
+   */
+  void Init() {
+    num_bars = 0;
+    last_bar_time = 0;
+    values_end_time = 0;
+    ++stats_num_instances;
+  }
+
+  /**
+   * Stores applied prices of the bars completed since the last update.
+   *
+   * New bar is detected by the time of the current bar, so the number of bars is only checked once per bar. Bars
+   * dropped from the start of the chart (when terminal limits number of bars) are removed from the values.
+   */
+  void Update() {
+    datetime _bar_time = ChartStatic::iTime(symbol, tf, 0);
+    if (_bar_time == last_bar_time) {
+      return;
+    }
+    last_bar_time = _bar_time;
+    num_bars = BarsFromStart();
+    ++stats_num_updates;
+
+    int _count = ArraySize(values);
+    int _num_completed = MathMax(0, num_bars - 1);
+    if (_count > 0) {
+      // Aligns values with the chart by the newest stored bar.
+      int _end_shift = ChartStatic::iBarShift(symbol, tf, values_end_time, true);
+      int _num_dropped = _end_shift < 0 ? -1 : _count - num_bars + _end_shift;
+      if (_num_dropped < 0 || _num_dropped > _count) {
+        // History has been reloaded.
+        _num_dropped = _count;
+      }
+      for (int i = _num_dropped; i < _count; ++i) {
+        values[i - _num_dropped] = values[i];
+      }
+      _count -= _num_dropped;
+      stats_num_values -= _num_dropped;
+    }
+    ArrayResize(values, _num_completed, 4096);
+    for (int i = _count; i < _num_completed; ++i) {
+      values[i] = GetAppliedPrice(num_bars - i - 1);
+    }
+    stats_num_values += _num_completed - _count;
+    values_end_time = ChartStatic::iTime(symbol, tf, 1);
+  }
+
+  /**
+   * Returns given price of the bar at a given shift of the chart (0 is the current bar).
+   */
+  double GetPrice(ENUM_APPLIED_PRICE _ap, int _real_shift) {
+    switch (_ap) {
+      case PRICE_OPEN:
+        return iOpen(symbol, tf, _real_shift);
+      case PRICE_HIGH:
+        return iHigh(symbol, tf, _real_shift);
+      case PRICE_LOW:
+        return iLow(symbol, tf, _real_shift);
+      case PRICE_CLOSE:
+        return iClose(symbol, tf, _real_shift);
+    }
+    return 0;
+  }
+
+  /**
+   * Returns applied price of the bar at a given shift of the chart (0 is the current bar).
+   */
+  double GetAppliedPrice(int _real_shift) {
+    switch (ap) {
+      case PRICE_OPEN:
+      case PRICE_HIGH:
+      case PRICE_LOW:
+      case PRICE_CLOSE:
+        return GetPrice(ap, _real_shift);
+      case PRICE_MEDIAN:
+        return (GetPrice(PRICE_HIGH, _real_shift) + GetPrice(PRICE_LOW, _real_shift)) / 2;
+      case PRICE_TYPICAL:
+        return (GetPrice(PRICE_HIGH, _real_shift) + GetPrice(PRICE_LOW, _real_shift) +
+                GetPrice(PRICE_CLOSE, _real_shift)) /
+               3;
+      case PRICE_WEIGHTED:
+        return (GetPrice(PRICE_HIGH, _real_shift) + GetPrice(PRICE_LOW, _real_shift) +
+                (2 * GetPrice(PRICE_CLOSE, _real_shift))) /
+               4;
+      default:
+        Print("We shouldn't be here!");
+        DebugBreak();
+    }
+    return 0.0;
+  }
+
  public:
   /**
    * Constructor.
    */
   PriceValueStorage(string _symbol = NULL, ENUM_TIMEFRAMES _tf = PERIOD_CURRENT, ENUM_APPLIED_PRICE _ap = PRICE_OPEN)
-      : ap(_ap), HistoryValueStorage(_symbol, _tf) {}
+      : ap(_ap), HistoryValueStorage(_symbol, _tf) {
+    Init();
+  }
 
   /**
    * Copy constructor.
    */
-  PriceValueStorage(const PriceValueStorage &_r) : ap(_r.ap), HistoryValueStorage(_r.symbol, _r.tf) {}
+  PriceValueStorage(const PriceValueStorage &_r) : ap(_r.ap), HistoryValueStorage(_r.symbol, _r.tf) { Init(); }
+
+  /**
+   * Destructor.
+   */
+  ~PriceValueStorage() {
+    --stats_num_instances;
+    stats_num_values -= ArraySize(values);
+  }
 
   /**
    * Returns pointer to PriceValueStorage of a given symbol and time-frame.
    */
   static PriceValueStorage *GetInstance(string _symbol, ENUM_TIMEFRAMES _tf, ENUM_APPLIED_PRICE _ap) {
     PriceValueStorage *_storage;
+    // Current symbol and time-frame may be passed in different ways, but they should share the same storage.
+    _symbol = _symbol == NULL || _symbol == "" ? _Symbol : _symbol;
+    _tf = _tf == PERIOD_CURRENT ? (ENUM_TIMEFRAMES)_Period : _tf;
     string _key = Util::MakeKey(_symbol, (int)_tf, (int)_ap);
+    ++stats_num_requests;
     if (!ObjectsCache<PriceValueStorage>::TryGet(_key, _storage)) {
       _storage = ObjectsCache<PriceValueStorage>::Set(_key, new PriceValueStorage(_symbol, _tf, _ap));
     }
@@ -69,38 +209,17 @@ class PriceValueStorage : public HistoryValueStorage<double> {
    * Fetches value from a given shift. Takes into consideration as-series flag.
    */
   virtual double Fetch(int _shift) {
-    switch (ap) {
-      case PRICE_OPEN:
-      case PRICE_HIGH:
-      case PRICE_LOW:
-      case PRICE_CLOSE:
-        return Fetch(ap, _shift);
-      case PRICE_MEDIAN:
-        return (Fetch(PRICE_HIGH, _shift) + Fetch(PRICE_LOW, _shift)) / 2;
-      case PRICE_TYPICAL:
-        return (Fetch(PRICE_HIGH, _shift) + Fetch(PRICE_LOW, _shift) + Fetch(PRICE_CLOSE, _shift)) / 3;
-      case PRICE_WEIGHTED:
-        return (Fetch(PRICE_HIGH, _shift) + Fetch(PRICE_LOW, _shift) + (2 * Fetch(PRICE_CLOSE, _shift))) / 4;
-      default:
-        Print("We shouldn't be here!");
-        DebugBreak();
+    Update();
+    int _index = is_series ? num_bars - _shift - 1 : _shift;
+    if (_index >= 0 && _index < ArraySize(values)) {
+      ++stats_num_fetches_stored;
+      return values[_index];
     }
-    return 0.0;
+    ++stats_num_fetches_live;
+    return GetAppliedPrice(num_bars - _index - 1);
   }
 
-  double Fetch(ENUM_APPLIED_PRICE _ap, int _shift) {
-    switch (_ap) {
-      case PRICE_OPEN:
-        return iOpen(symbol, tf, RealShift(_shift));
-      case PRICE_HIGH:
-        return iHigh(symbol, tf, RealShift(_shift));
-      case PRICE_LOW:
-        return iLow(symbol, tf, RealShift(_shift));
-      case PRICE_CLOSE:
-        return iClose(symbol, tf, RealShift(_shift));
-    }
-    return 0;
-  }
+  double Fetch(ENUM_APPLIED_PRICE _ap, int _shift) { return GetPrice(_ap, RealShift(_shift)); }
 
   static double GetApplied(ValueStorage<double> &_open, ValueStorage<double> &_high, ValueStorage<double> &_low,
                            ValueStorage<double> &_close, int _shift, ENUM_APPLIED_PRICE _ap) {
@@ -118,4 +237,61 @@ class PriceValueStorage : public HistoryValueStorage<double> {
     DebugBreak();
     return 0;
   }
+
+  /* Statistics */
+
+  /**
+   * Returns number of existing price storages.
+   */
+  static int GetStatsNumInstances() { return stats_num_instances; }
+
+  /**
+   * Returns number of stored applied prices of all storages.
+   */
+  static long GetStatsNumValues() { return stats_num_values; }
+
+  /**
+   * Returns memory used by stored applied prices of all storages (in bytes).
+   */
+  static long GetStatsMemory() { return stats_num_values * sizeof(double); }
+
+  /**
+   * Returns number of fetches served from the stored applied prices.
+   */
+  static long GetStatsNumFetchesStored() { return stats_num_fetches_stored; }
+
+  /**
+   * Returns number of fetches served directly from the chart (the current bar).
+   */
+  static long GetStatsNumFetchesLive() { return stats_num_fetches_live; }
+
+  /**
+   * Returns number of updates of stored applied prices (once per new bar per storage).
+   */
+  static long GetStatsNumUpdates() { return stats_num_updates; }
+
+  /**
+   * Returns number of GetInstance() calls. Every call except the first one per storage reuses existing storage.
+   */
+  static long GetStatsNumRequests() { return stats_num_requests; }
+
+  /**
+   * Returns statistics of all price storages as text.
+   */
+  static string GetStatsText() {
+    return "Price storages: " + IntegerToString(stats_num_instances) + " (" + IntegerToString(stats_num_requests) +
+           " requests), stored values: " + IntegerToString(stats_num_values) + " (" +
+           IntegerToString(GetStatsMemory() / 1024) + " KB), updates: " + IntegerToString(stats_num_updates) +
+           ", fetches: " + IntegerToString(stats_num_fetches_stored) + " stored, " +
+           IntegerToString(stats_num_fetches_live) + " live.";
+  }
 };
+
+int PriceValueStorage::stats_num_instances = 0;
+long PriceValueStorage::stats_num_values = 0;
+long PriceValueStorage::stats_num_fetches_stored = 0;
+long PriceValueStorage::stats_num_fetches_live = 0;
+long PriceValueStorage::stats_num_updates = 0;
+long PriceValueStorage::stats_num_requests = 0;
+
+#endif  // VALUE_STORAGE_PRICE_H
@@ -0,0 +1,412 @@
+//+------------------------------------------------------------------+
+//|                                                EA31337 framework |
+//|                                 Copyright 2016-2022, EA31337 Ltd |
+//|                                       https://github.com/EA31337 |
+//+------------------------------------------------------------------+
+
+/*
+ *  This file is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file
+ * Streaming ZigZag calculation.
+ */
+
+#ifndef __MQL__
+// Allows the preprocessor to include a header file when it is needed.
+#pragma once
+#endif
+
+// Prevents processing this includes file multiple times.
+#ifndef ZIGZAG_STREAM_H
+#define ZIGZAG_STREAM_H
+
+// Includes.
+#include "../Refs.mqh"
+#include "../Std.h"
+#include "PivotList.h"
+#include "RollingPeak.h"
+#include "ValueStorage.h"
+
+// Enums.
+enum ENUM_ZIGZAG_STREAM_SEARCH {
+  ZIGZAG_STREAM_SEARCH_EXTREMUM = 0,  // Searching for the first extremum.
+  ZIGZAG_STREAM_SEARCH_PEAK = 1,      // Searching for the next ZigZag peak.
+  ZIGZAG_STREAM_SEARCH_BOTTOM = -1,   // Searching for the next ZigZag bottom.
+};
+
+// Structs.
+/**
+ * State of the final selection of ZigZag's extremes.
+ */
+struct ZigZagStreamSearch {
+  ENUM_ZIGZAG_STREAM_SEARCH search;
+  double last_high, last_low;
+  int last_high_pos, last_low_pos;
+  ZigZagStreamSearch()
+      : search(ZIGZAG_STREAM_SEARCH_EXTREMUM), last_high(0), last_low(0), last_high_pos(0), last_low_pos(0) {}
+};
+
+/**
+ * Calculates ZigZag (the same way as the "Examples\ZigZag" indicator does) one bar at a time.
+ *
+ * Each completed bar is processed once: the highest and the lowest price of the depth are kept by monotonic deques
+ * and high/low maps are kept only for the last backstep bars, which may still be cleared by newer bars. Once bar's maps
+ * can't change anymore, bar is passed to the extremum search state machine. ZigZag and both maps are stored as
+ * compact pivot lists instead of per-bar buffers.
+ *
+ * The forming bar and bars whose maps may still change are calculated on a copy of the state after each update, which
+ * costs O(backstep).
+ */
+class ZigZagStream : public Dynamic {
+ protected:
+  // Parameters.
+  int depth;
+  int deviation;
+  int backstep;
+  double point;
+
+  // Highest and lowest prices of the last (depth - 1) completed bars.
+  RollingPeak highest;
+  RollingPeak lowest;
+
+  // High and low maps of the last (backstep + 1) bars, indexed by the bar index modulo (backstep + 1).
+  ARRAY(double, high_map);
+  ARRAY(double, low_map);
+  double map_last_high, map_last_low;
+
+  // Extremum search state of the committed bars.
+  ZigZagStreamSearch state;
+
+  // Committed values.
+  PivotList pivots;
+  PivotList high_pivots;
+  PivotList low_pivots;
+
+  // Number of completed bars processed.
+  int num_bars;
+
+  // Pending values (bars which aren't committed yet and the forming bar).
+  ARRAY(double, pending_high_map);
+  ARRAY(double, pending_low_map);
+  PivotList pending_pivots;
+  int pending_from;  // Bar index from which ZigZag values are taken from pending pivots.
+  int total;         // Number of bars including the forming one.
+  double forming_high, forming_low;
+
+  /**
+   * Calculates high and low maps of the given bar. Clears maps of up to backstep previous bars.
+   */
+  void CalculateMaps(int _index, double _high, double _low, ARRAY_REF(double, _high_map), ARRAY_REF(double, _low_map),
+                     double &_map_last_high, double &_map_last_low) {
+    int _size = backstep + 1;
+    int _pos = _index % _size;
+    int _back;
+    double _val;
+
+    if (_index < depth) {
+      _high_map[_pos] = 0.0;
+      _low_map[_pos] = 0.0;
+      return;
+    }
+
+    // Low.
+    _val = depth > 1 ? MathMin(lowest.GetPeak(), _low) : _low;
+    if (_val == _map_last_low) {
+      _val = 0.0;
+    } else {
+      _map_last_low = _val;
+      if (_low - _val > deviation * point) {
+        _val = 0.0;
+      } else {
+        for (_back = 1; _back <= backstep && _index - _back >= 0; _back++) {
+          int _bpos = (_index - _back) % _size;
+          if (_low_map[_bpos] != 0 && _low_map[_bpos] > _val) {
+            _low_map[_bpos] = 0.0;
+          }
+        }
+      }
+    }
+    _low_map[_pos] = _low == _val ? _val : 0.0;
+
+    // High.
+    _val = depth > 1 ? MathMax(highest.GetPeak(), _high) : _high;
+    if (_val == _map_last_high) {
+      _val = 0.0;
+    } else {
+      _map_last_high = _val;
+      if (_val - _high > deviation * point) {
+        _val = 0.0;
+      } else {
+        for (_back = 1; _back <= backstep && _index - _back >= 0; _back++) {
+          int _bpos = (_index - _back) % _size;
+          if (_high_map[_bpos] != 0 && _high_map[_bpos] < _val) {
+            _high_map[_bpos] = 0.0;
+          }
+        }
+      }
+    }
+    _high_map[_pos] = _high == _val ? _val : 0.0;
+  }
+
+  /**
+   * Passes the bar with the final maps to the extremum search.
+   */
+  void Select(int _index, double _high_map, double _low_map, ZigZagStreamSearch &_state, PivotList &_pivots) {
+    switch (_state.search) {
+      case ZIGZAG_STREAM_SEARCH_EXTREMUM:
+        if (_high_map != 0.0) {
+          _state.last_high = _high_map;
+          _state.last_high_pos = _index;
+          _state.search = ZIGZAG_STREAM_SEARCH_BOTTOM;
+          _pivots.Set(_index, _high_map);
+        }
+        if (_low_map != 0.0) {
+          _state.last_low = _low_map;
+          _state.last_low_pos = _index;
+          _state.search = ZIGZAG_STREAM_SEARCH_PEAK;
+          _pivots.Set(_index, _low_map);
+        }
+        break;
+      case ZIGZAG_STREAM_SEARCH_PEAK:
+        if (_low_map != 0.0 && _low_map < _state.last_low && _high_map == 0.0) {
+          _pivots.Remove(_state.last_low_pos);
+          _state.last_low_pos = _index;
+          _state.last_low = _low_map;
+          _pivots.Set(_index, _low_map);
+        }
+        if (_high_map != 0.0 && _low_map == 0.0) {
+          _state.last_high = _high_map;
+          _state.last_high_pos = _index;
+          _state.search = ZIGZAG_STREAM_SEARCH_BOTTOM;
+          _pivots.Set(_index, _high_map);
+        }
+        break;
+      case ZIGZAG_STREAM_SEARCH_BOTTOM:
+        if (_high_map != 0.0 && _high_map > _state.last_high && _low_map == 0.0) {
+          _pivots.Remove(_state.last_high_pos);
+          _state.last_high_pos = _index;
+          _state.last_high = _high_map;
+          _pivots.Set(_index, _high_map);
+        }
+        if (_low_map != 0.0 && _high_map == 0.0) {
+          _state.last_low = _low_map;
+          _state.last_low_pos = _index;
+          _state.search = ZIGZAG_STREAM_SEARCH_PEAK;
+          _pivots.Set(_index, _low_map);
+        }
+        break;
+    }
+  }
+
+  /**
+   * Processes the next completed bar without calculating pending bars.
+   */
+  void Commit(double _high, double _low) {
+    CalculateMaps(num_bars, _high, _low, high_map, low_map, map_last_high, map_last_low);
+    if (depth > 1) {
+      highest.Push(_high);
+      lowest.Push(_low);
+    }
+    ++num_bars;
+
+    // Maps of the bar backstep bars ago can't change anymore.
+    int _index = num_bars - 1 - backstep;
+    if (_index >= 0) {
+      int _pos = _index % (backstep + 1);
+      if (high_map[_pos] != 0.0) {
+        high_pivots.Set(_index, high_map[_pos]);
+      }
+      if (low_map[_pos] != 0.0) {
+        low_pivots.Set(_index, low_map[_pos]);
+      }
+      Select(_index, high_map[_pos], low_map[_pos], state, pivots);
+    }
+  }
+
+  /**
+   * Calculates pending bars (and the forming bar, if any) on the copy of the state.
+   */
+  void CalculatePending(bool _has_forming, double _high, double _low) {
+    int _size = backstep + 1;
+    ArrayCopy(pending_high_map, high_map);
+    ArrayCopy(pending_low_map, low_map);
+    total = num_bars;
+
+    if (_has_forming) {
+      double _map_last_high = map_last_high, _map_last_low = map_last_low;
+      CalculateMaps(num_bars, _high, _low, pending_high_map, pending_low_map, _map_last_high, _map_last_low);
+      ++total;
+    }
+    forming_high = _high;
+    forming_low = _low;
+
+    ZigZagStreamSearch _state = state;
+    int _first = MathMax(0, num_bars - backstep);
+    switch (_state.search) {
+      case ZIGZAG_STREAM_SEARCH_PEAK:
+        pending_from = _state.last_low_pos;
+        break;
+      case ZIGZAG_STREAM_SEARCH_BOTTOM:
+        pending_from = _state.last_high_pos;
+        break;
+      default:
+        pending_from = _first;
+    }
+    pending_pivots.CopyFrom(pivots, pending_from);
+    for (int i = _first; i < total; ++i) {
+      Select(i, pending_high_map[i % _size], pending_low_map[i % _size], _state, pending_pivots);
+    }
+  }
+
+ public:
+  /* Special methods */
+
+  /**
+   * Class constructor.
+   *
+   * @param _point
+   *   Symbol's point, deviation is given in points.
+   */
+  ZigZagStream(int _depth = 12, int _deviation = 5, int _backstep = 3, double _point = 0.00001)
+      : depth(_depth), deviation(_deviation), backstep(MathMax(0, _backstep)), point(_point) {
+    highest.SetPeriod(MathMax(1, depth - 1));
+    lowest.SetPeriod(MathMax(1, depth - 1));
+    lowest.SetType(IPEAK_LOWEST);
+    ArrayResize(high_map, backstep + 1);
+    ArrayResize(low_map, backstep + 1);
+    Clear();
+  }
+
+  /* Getters */
+
+  /**
+   * Returns number of bars used to search for the highest and the lowest price.
+   */
+  int GetDepth() { return depth; }
+
+  /**
+   * Returns minimal number of points between the extremum and the bar's price.
+   */
+  int GetDeviation() { return deviation; }
+
+  /**
+   * Returns number of bars between maximums or minimums.
+   */
+  int GetBackstep() { return backstep; }
+
+  /**
+   * Returns symbol's point used for deviation.
+   */
+  double GetPoint() { return point; }
+
+  /**
+   * Returns number of bars including the forming one.
+   */
+  int GetTotal() { return total; }
+
+  /**
+   * Returns number of processed completed bars.
+   */
+  int GetCompletedBars() { return num_bars; }
+
+  /**
+   * Returns committed ZigZag pivots (values of bars which can't change anymore).
+   */
+  PivotList *GetPivots() { return &pivots; }
+
+  /**
+   * Returns ZigZag value of the bar at a given index (0 is the oldest bar) or 0 if bar isn't an extremum.
+   */
+  double GetZigZag(int _index) { return _index >= pending_from ? pending_pivots.Get(_index) : pivots.Get(_index); }
+
+  /**
+   * Returns high map value of the bar at a given index (0 is the oldest bar).
+   */
+  double GetHighMap(int _index) {
+    if (_index >= num_bars - backstep && _index < total) {
+      return pending_high_map[_index % (backstep + 1)];
+    }
+    return high_pivots.Get(_index);
+  }
+
+  /**
+   * Returns low map value of the bar at a given index (0 is the oldest bar).
+   */
+  double GetLowMap(int _index) {
+    if (_index >= num_bars - backstep && _index < total) {
+      return pending_low_map[_index % (backstep + 1)];
+    }
+    return low_pivots.Get(_index);
+  }
+
+  /* Main methods */
+
+  /**
+   * Processes the next completed bar (e.g. on the new bar event). Costs amortized O(1) plus O(backstep) for pending
+   * bars.
+   */
+  void ProcessBar(double _high, double _low) {
+    Commit(_high, _low);
+    CalculatePending(false, 0, 0);
+  }
+
+  /**
+   * Processes new completed bars and the forming (the last) bar of given prices.
+   *
+   * Completed bars are processed only once, so prices of bars which have already been processed must stay the same.
+   */
+  void Update(ValueStorage<double> &_high, ValueStorage<double> &_low, int _total) {
+    if (_total - 1 < num_bars) {
+      // History has been shortened.
+      Clear();
+    }
+    bool _is_new_bar = num_bars < _total - 1;
+    while (num_bars < _total - 1) {
+      Commit(_high[num_bars].Get(), _low[num_bars].Get());
+    }
+    if (_total > 0) {
+      double _forming_high = _high[_total - 1].Get(), _forming_low = _low[_total - 1].Get();
+      if (_is_new_bar || total != _total || _forming_high != forming_high || _forming_low != forming_low) {
+        CalculatePending(true, _forming_high, _forming_low);
+      }
+    }
+  }
+
+  /**
+   * Removes all processed bars.
+   */
+  void Clear() {
+    highest.Clear();
+    lowest.Clear();
+    ArrayInitialize(high_map, 0.0);
+    ArrayInitialize(low_map, 0.0);
+    map_last_high = 0;
+    map_last_low = 0;
+    ZigZagStreamSearch _state;
+    state = _state;
+    pivots.Clear();
+    high_pivots.Clear();
+    low_pivots.Clear();
+    num_bars = 0;
+    pending_pivots.Clear();
+    pending_from = 0;
+    total = 0;
+    forming_high = 0;
+    forming_low = 0;
+  }
+};
+
+#endif  // ZIGZAG_STREAM_H
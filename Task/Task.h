@@ -39,6 +39,7 @@
 #include "../Terminal.define.h"
 #include "Task.enum.h"
 #include "Task.struct.h"
+#include "TaskPlan.struct.h"
 #include "TaskAction.h"
 #include "TaskCondition.h"
 #include "Taskable.h"
@@ -47,6 +48,7 @@ class Task : public Taskable<TaskEntry> {
  public:
   // Class variables.
   DictStruct<short, TaskEntry> tasks;
+  TaskPlan plan;
 
   /* Special methods */
 
@@ -71,7 +73,30 @@ class Task : public Taskable<TaskEntry> {
   /**
    * Adds new task.
    */
-  void Add(TaskEntry &_entry) { tasks.Push(_entry); }
+  void Add(TaskEntry &_entry) {
+    tasks.Push(_entry);
+    if (plan.IsCompiled()) {
+      plan.Add(_entry);
+    }
+  }
+
+  /**
+   * Compiles tasks into a flat plan.
+   *
+   * Once compiled, tasks are processed from the plan by reference, so entries' state (e.g. flags) persists between
+   * calls, flag counts are maintained as counters and repeated Process() calls don't allocate. Entries having both,
+   * condition and action functions registered (see SetConditionFunction() and SetActionFunction()) are processed by
+   * calling them directly with the plan's typed arguments. Note that entries stored in the plan are no longer
+   * synchronized with GetTasks().
+   */
+  void Compile() {
+    plan.Clear();
+    for (DictStructIterator<short, TaskEntry> iter = tasks.Begin(); iter.IsValid(); ++iter) {
+      TaskEntry _entry = iter.Value();
+      plan.Add(_entry);
+    }
+    plan.is_compiled = true;
+  }
 
   /* Virtual methods */
 
@@ -83,6 +108,14 @@ class Task : public Taskable<TaskEntry> {
    */
   virtual bool Process() {
     bool _result = true;
+    if (plan.IsCompiled()) {
+      for (int i = 0; i < plan.Size(); i++) {
+        unsigned char _flags = plan.entries[i].GetFlags();
+        _result &= plan.IsBound(i) ? plan.Run(i) : Process(plan.entries[i]);
+        plan.Update(i, _flags);
+      }
+      return _result;
+    }
     for (DictStructIterator<short, TaskEntry> iter = tasks.Begin(); iter.IsValid(); ++iter) {
       TaskEntry _entry = iter.Value();
       _result &= Process(_entry);
@@ -220,6 +253,9 @@ class Task : public Taskable<TaskEntry> {
    * Count entry flags.
    */
   unsigned int GetFlagCount(ENUM_TASK_ENTRY_FLAGS _flag) {
+    if (plan.IsCompiled()) {
+      return plan.GetFlagCount(_flag);
+    }
     unsigned int _counter = 0;
     for (DictStructIterator<short, TaskEntry> iter = tasks.Begin(); iter.IsValid(); ++iter) {
       TaskEntry _entry = iter.Value();
@@ -232,10 +268,23 @@ class Task : public Taskable<TaskEntry> {
 
   /* Setters */
 
+  /**
+   * Sets function to check conditions of the given id in the compiled plan.
+   */
+  void SetConditionFunction(int _id, TaskPlanFunction _fn) { plan.SetConditionFunction(_id, _fn); }
+
+  /**
+   * Sets function to run actions of the given id in the compiled plan.
+   */
+  void SetActionFunction(int _id, TaskPlanFunction _fn) { plan.SetActionFunction(_id, _fn); }
+
   /**
    * Sets entry flags.
    */
   bool SetFlags(ENUM_TASK_ENTRY_FLAGS _flag, bool _value = true) {
+    if (plan.IsCompiled()) {
+      return plan.SetFlags(_flag, _value) > 0;
+    }
     unsigned int _counter = 0;
     for (DictStructIterator<short, TaskEntry> iter = tasks.Begin(); iter.IsValid(); ++iter) {
       TaskEntry _entry = iter.Value();
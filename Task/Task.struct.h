@@ -123,6 +123,7 @@ struct TaskEntry {
       RemoveFlags(_flag);
   }
   void SetFlags(unsigned char _flags) { flags = _flags; }
+  unsigned char GetFlags() { return flags; }
   // State methods.
   bool IsActive() { return HasFlag(TASK_ENTRY_FLAG_IS_ACTIVE); }
   bool IsDone() { return HasFlag(TASK_ENTRY_FLAG_IS_DONE); }
@@ -133,6 +134,15 @@ struct TaskEntry {
   int GetConditionId() { return cond.GetId(); }
   TaskActionEntry GetAction() { return action; }
   TaskConditionEntry GetCondition() { return cond; }
+  // Dispatch methods (pass the entries by reference, without copying their arguments).
+  template <typename T>
+  bool CheckCondition(T _obj) {
+    return _obj PTR_DEREF Check(cond);
+  }
+  template <typename T>
+  bool RunAction(T _obj) {
+    return _obj PTR_DEREF Run(action);
+  }
 
  public:
   SerializerNodeType Serialize(Serializer &s) {
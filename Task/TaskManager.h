@@ -39,18 +39,80 @@
 #include "../SerializerConverter.mqh"
 #include "../SerializerJson.mqh"
 #include "Task.struct.h"
+#include "TaskManager.enum.h"
+#include "TaskManager.struct.h"
 #include "TaskObject.h"
+#include "TaskTimingWheel.h"
 
+// Defines.
+// Names of events triggered by EA.
+#define TASK_MANAGER_EVENT_NEW_BAR "NewBar"
+#define TASK_MANAGER_EVENT_ORDER_OPENED "OrderOpened"
+#define TASK_MANAGER_EVENT_SIGNAL "Signal"
+
+/**
+ * Manages and processes tasks.
+ *
+ * Tasks added by Add() are processed on every call of Process(). In the
+ * scheduler mode, tasks added by AddScheduled() or AddOnEvent() are processed
+ * only when they are due (kept in a timing wheel) or when the event they are
+ * subscribed to has been triggered (e.g., new bar, order opened, signal).
+ */
 class TaskManager {
  protected:
   DictStruct<int, Ref<Task>> tasks;
 
+  // Scheduler.
+  ENUM_TASK_MANAGER_MODE mode;
+  ARRAY(Ref<Task>, scheduled);             // Scheduled tasks by their identifiers.
+  ARRAY(int, sched_interval);              // Seconds between runs (0 for event-only tasks).
+  ARRAY(long, sched_next_time);            // Time of the next run.
+  ARRAY(unsigned long, sched_last_call);   // Number of the Process() call which processed the task.
+  ARRAY(unsigned char, sched_is_pending);  // Whether task has been triggered by an event.
+  ARRAY(int, pending);                     // Triggered tasks.
+  ARRAY(int, due);                         // Reusable array of due tasks.
+  ARRAY(TaskManagerEvent, events);         // Subscribers of each event.
+  DictStruct<string, int> event_indices;   // Index of the event in events by its name.
+  TaskTimingWheel wheel;
+  int num_pending;
+  unsigned long num_calls;
+
+  // Counters.
+  unsigned long num_executed;  // Number of processed tasks.
+  unsigned long num_skipped;   // Number of scheduled tasks skipped, because they weren't due.
+
   /* Protected methods */
 
   /**
    * Init code (called on constructor).
    */
-  void Init() {}
+  void Init() {
+    mode = TASK_MANAGER_MODE_ALL;
+    num_pending = 0;
+    num_calls = 0;
+    num_executed = 0;
+    num_skipped = 0;
+  }
+
+  /**
+   * Returns index of the event with the given name or -1 if not found.
+   */
+  int GetEventIndex(string _event) {
+    int _missing = -1;
+    return event_indices.GetByKey(_event, _missing);
+  }
+
+  /**
+   * Processes scheduled task unless it has been already processed by the current call.
+   */
+  bool ProcessScheduled(int _id, int &_num_processed) {
+    if (sched_last_call[_id] == num_calls) {
+      return true;
+    }
+    sched_last_call[_id] = num_calls;
+    ++_num_processed;
+    return scheduled[_id].Ptr() PTR_DEREF Process();
+  }
 
  public:
   /* Special methods */
@@ -93,6 +155,83 @@ class TaskManager {
     return Add((Task *)_task_obj);
   }
 
+  /**
+   * Adds new task processed periodically in the scheduler mode.
+   *
+   * @param _interval
+   *   Seconds between runs. Use 0 for task processed only when triggered by an event (see Subscribe()).
+   * @param _time
+   *   Time of the first run. By default task is processed by the next call of Process().
+   *
+   * @return
+   *   Returns identifier of the scheduled task.
+   */
+  int AddScheduled(Task *_task, int _interval, long _time = 0) {
+    int _id = ArraySize(scheduled);
+    ArrayResize(scheduled, _id + 1, 32);
+    scheduled[_id] = _task;
+    ArrayResize(sched_interval, _id + 1, 32);
+    ArrayResize(sched_next_time, _id + 1, 32);
+    ArrayResize(sched_last_call, _id + 1, 32);
+    ArrayResize(sched_is_pending, _id + 1, 32);
+    sched_interval[_id] = _interval;
+    sched_next_time[_id] = _time;
+    sched_last_call[_id] = 0;
+    sched_is_pending[_id] = 0;
+    if (_interval > 0) {
+      wheel.Insert(_id, _time);
+    }
+    return _id;
+  }
+
+  /**
+   * Adds new task processed in the scheduler mode only when the given event is triggered.
+   *
+   * @return
+   *   Returns identifier of the scheduled task.
+   */
+  int AddOnEvent(Task *_task, string _event) {
+    int _id = AddScheduled(_task, 0);
+    Subscribe(_id, _event);
+    return _id;
+  }
+
+  /* Events */
+
+  /**
+   * Subscribes scheduled task to the given event.
+   */
+  void Subscribe(int _id, string _event) {
+    int _index = GetEventIndex(_event);
+    if (_index == -1) {
+      _index = ArraySize(events);
+      ArrayResize(events, _index + 1, 8);
+      events[_index].name = _event;
+      event_indices.Set(_event, _index);
+    }
+    events[_index].Subscribe(_id);
+  }
+
+  /**
+   * Triggers the given event. Subscribed tasks are processed by the next call of Process().
+   */
+  void Trigger(string _event) {
+    int _index = GetEventIndex(_event);
+    if (_index == -1) {
+      return;
+    }
+    for (int i = 0; i < ArraySize(events[_index].ids); ++i) {
+      int _id = events[_index].ids[i];
+      if (!sched_is_pending[_id]) {
+        sched_is_pending[_id] = 1;
+        if (num_pending >= ArraySize(pending)) {
+          ArrayResize(pending, num_pending + 1, 32);
+        }
+        pending[num_pending++] = _id;
+      }
+    }
+  }
+
   /* Getters */
 
   /**
@@ -102,17 +241,81 @@ class TaskManager {
     return &tasks;
   }
 
+  /**
+   * Returns mode in which tasks are processed.
+   */
+  ENUM_TASK_MANAGER_MODE GetMode() { return mode; }
+
+  /**
+   * Returns number of processed tasks.
+   */
+  unsigned long GetExecutedCount() { return num_executed; }
+
+  /**
+   * Returns number of scheduled tasks which weren't processed, because they weren't due.
+   */
+  unsigned long GetSkippedCount() { return num_skipped; }
+
+  /* Setters */
+
+  /**
+   * Sets mode in which tasks are processed.
+   */
+  void SetMode(ENUM_TASK_MANAGER_MODE _mode) { mode = _mode; }
+
+  /**
+   * Resets counters of processed and skipped tasks.
+   */
+  void ResetCounters() {
+    num_executed = 0;
+    num_skipped = 0;
+  }
+
   /* Processing methods */
 
   /**
    * Process tasks.
    */
-  bool Process() {
+  bool Process() { return Process((long)TimeCurrent()); }
+
+  /**
+   * Process tasks at the given time.
+   */
+  bool Process(long _time) {
     bool _result = true;
+    int i, _num_processed = 0;
+    ++num_calls;
+
     for (DictStructIterator<int, Ref<Task>> _iter = tasks.Begin(); _iter.IsValid(); ++_iter) {
       Task *_task = _iter.Value().Ptr();
       _result &= _task PTR_DEREF Process();
     }
+    num_executed += tasks.Size();
+
+    if (mode == TASK_MANAGER_MODE_ALL) {
+      for (i = 0; i < ArraySize(scheduled); ++i) {
+        _result &= ProcessScheduled(i, _num_processed);
+      }
+    } else {
+      // Due tasks.
+      int _num_due = wheel.Advance(_time, due);
+      for (i = 0; i < _num_due; ++i) {
+        int _id = due[i];
+        _result &= ProcessScheduled(_id, _num_processed);
+        long _next_time = sched_next_time[_id] + sched_interval[_id];
+        sched_next_time[_id] = _next_time > _time ? _next_time : _time + sched_interval[_id];
+        wheel.Insert(_id, sched_next_time[_id]);
+      }
+      // Tasks triggered by events.
+      for (i = 0; i < num_pending; ++i) {
+        sched_is_pending[pending[i]] = 0;
+        _result &= ProcessScheduled(pending[i], _num_processed);
+      }
+      num_pending = 0;
+    }
+
+    num_executed += _num_processed;
+    num_skipped += ArraySize(scheduled) - _num_processed;
     return _result;
   }
 };
@@ -0,0 +1,50 @@
+//+------------------------------------------------------------------+
+//|                                                EA31337 framework |
+//|                                 Copyright 2016-2021, EA31337 Ltd |
+//|                                       https://github.com/EA31337 |
+//+------------------------------------------------------------------+
+
+/*
+ * This file is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file
+ * Includes TaskManager's structs.
+ */
+
+#ifndef __MQL__
+// Allows the preprocessor to include a header file when it is needed.
+#pragma once
+#endif
+
+// Includes.
+#include "../Std.h"
+
+/* Named event which wakes up subscribed tasks. */
+struct TaskManagerEvent {
+  string name;      // Name of the event.
+  ARRAY(int, ids);  // Identifiers of subscribed scheduled tasks.
+  // Methods.
+  void Subscribe(int _id) {
+    for (int i = 0; i < ArraySize(ids); ++i) {
+      if (ids[i] == _id) {
+        return;
+      }
+    }
+    ArrayResize(ids, ArraySize(ids) + 1, 8);
+    ids[ArraySize(ids) - 1] = _id;
+  }
+};
@@ -69,14 +69,7 @@ class TaskObject : public Task {
    * @return
    *   Returns true when tasks has been processed.
    */
-  virtual bool Process() {
-    bool _result = true;
-    for (DictStructIterator<short, TaskEntry> iter = tasks.Begin(); iter.IsValid(); ++iter) {
-      TaskEntry _entry = iter.Value();
-      _result &= Process(_entry);
-    }
-    return _result;
-  }
+  virtual bool Process() { return Task::Process(); }
 
   /**
    * Process task entry.
@@ -87,8 +80,8 @@ class TaskObject : public Task {
   virtual bool Process(TaskEntry &_entry) {
     bool _result = false;
     if (_entry.IsActive()) {
-      if (Object::IsValid(objc) && objc PTR_DEREF Check(_entry.GetCondition()) && Object::IsValid(obja)) {
-        obja PTR_DEREF Run(_entry.GetAction());
+      if (Object::IsValid(objc) && _entry.CheckCondition(objc) && Object::IsValid(obja)) {
+        _entry.RunAction(obja);
         _entry.Set(STRUCT_ENUM(TaskEntry, TASK_ENTRY_PROP_LAST_PROCESS), TimeCurrent());
         if (_entry.IsDone()) {
           _entry.SetFlag(TASK_ENTRY_FLAG_IS_DONE,
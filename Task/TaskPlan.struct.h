@@ -0,0 +1,353 @@
+//+------------------------------------------------------------------+
+//|                                                EA31337 framework |
+//|                                 Copyright 2016-2021, EA31337 Ltd |
+//|                                       https://github.com/EA31337 |
+//+------------------------------------------------------------------+
+
+/*
+ * This file is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file
+ * Includes TaskPlan's structs.
+ */
+
+#ifndef __MQL__
+// Allows the preprocessor to include a header file when it is needed.
+#pragma once
+#endif
+
+// Includes.
+#include "Task.struct.h"
+
+// Forward declarations.
+struct TaskPlan;
+
+/**
+ * Function bound to the condition or action of the compiled entry.
+ *
+ * Arguments are read from the plan's typed slots, e.g. by GetConditionArgDouble(_index, 0).
+ *
+ * @return
+ *   Returns result of the condition's check or the action's run.
+ */
+typedef bool (*TaskPlanFunction)(TaskPlan &_plan, int _index);
+
+/**
+ * Compiled (flat) form of task entries.
+ *
+ * Entries are stored in a plain array and processed by reference, so changes
+ * made to them while processing persist. Arguments of conditions and actions
+ * are pre-converted into typed slots and the number of entries having each
+ * flag is maintained as counters, so processing doesn't allocate anything.
+ *
+ * Functions registered for condition and action ids are bound to entries when
+ * they are added, so bound entries are processed by direct calls instead of
+ * dispatching by id.
+ */
+struct TaskPlan {
+ public:
+  ARRAY(TaskEntry, entries);            // Task entries.
+  ARRAY(long, args_integer);            // Arguments converted into integer values.
+  ARRAY(double, args_double);           // Arguments converted into double values.
+  ARRAY(int, args_cond_offset);         // Offset of the condition's arguments per entry.
+  ARRAY(int, args_cond_count);          // Number of the condition's arguments per entry.
+  ARRAY(int, args_action_offset);       // Offset of the action's arguments per entry.
+  ARRAY(int, args_action_count);        // Number of the action's arguments per entry.
+  ARRAY(int, flag_counts);              // Number of entries per flag bit.
+  ARRAY(TaskPlanFunction, cond_fns);    // Condition's function bound per entry (or NULL).
+  ARRAY(TaskPlanFunction, action_fns);  // Action's function bound per entry (or NULL).
+  ARRAY(int, fn_cond_ids);              // Condition ids having registered functions.
+  ARRAY(TaskPlanFunction, fn_conds);    // Functions registered for condition ids.
+  ARRAY(int, fn_action_ids);            // Action ids having registered functions.
+  ARRAY(TaskPlanFunction, fn_actions);  // Functions registered for action ids.
+  bool is_compiled;                     // Whether task's entries has been compiled.
+
+ protected:
+  /**
+   * Appends arguments into typed slots.
+   *
+   * @return
+   *   Returns offset of the first appended argument.
+   */
+  int AddArgs(ARRAY_REF(DataParamEntry, _args)) {
+    int _offset = ArraySize(args_integer);
+    int _size = _offset + ArraySize(_args);
+    ArrayResize(args_integer, _size);
+    ArrayResize(args_double, _size);
+    for (int i = 0; i < ArraySize(_args); i++) {
+      if (_args[i].type == TYPE_DOUBLE || _args[i].type == TYPE_FLOAT) {
+        args_integer[_offset + i] = (long)_args[i].double_value;
+        args_double[_offset + i] = _args[i].double_value;
+      } else {
+        args_integer[_offset + i] = _args[i].integer_value;
+        args_double[_offset + i] = (double)_args[i].integer_value;
+      }
+    }
+    return _offset;
+  }
+
+  /**
+   * Returns function registered for the given id or NULL.
+   */
+  TaskPlanFunction FindFunction(ARRAY_REF(int, _ids), ARRAY_REF(TaskPlanFunction, _fns), int _id) {
+    for (int i = 0; i < ArraySize(_ids); i++) {
+      if (_ids[i] == _id) {
+        return _fns[i];
+      }
+    }
+    return NULL;
+  }
+
+  /**
+   * Registers function for the given id.
+   */
+  void RegisterFunction(ARRAY_REF(int, _ids), ARRAY_REF(TaskPlanFunction, _fns), int _id, TaskPlanFunction _fn) {
+    int _index = 0;
+    while (_index < ArraySize(_ids) && _ids[_index] != _id) {
+      _index++;
+    }
+    if (_index == ArraySize(_ids)) {
+      ArrayResize(_ids, _index + 1);
+      ArrayResize(_fns, _index + 1);
+      _ids[_index] = _id;
+    }
+    _fns[_index] = _fn;
+  }
+
+  /**
+   * Binds registered functions to the given entry.
+   */
+  void Bind(int _index) {
+    cond_fns[_index] = FindFunction(fn_cond_ids, fn_conds, entries[_index].GetConditionId());
+    action_fns[_index] = FindFunction(fn_action_ids, fn_actions, entries[_index].GetActionId());
+  }
+
+  /**
+   * Increments (or decrements) counters of the given flags.
+   */
+  void CountFlags(unsigned char _flags, int _delta) {
+    for (int _bit = 0; _flags != 0; _bit++, _flags >>= 1) {
+      if ((_flags & 1) != 0) {
+        flag_counts[_bit] += _delta;
+      }
+    }
+  }
+
+ public:
+  /* Special methods */
+
+  TaskPlan() { Clear(); }
+
+  /* Getters */
+
+  /**
+   * Returns number of entries.
+   */
+  int Size() { return ArraySize(entries); }
+
+  /**
+   * Checks whether plan has been compiled.
+   */
+  bool IsCompiled() { return is_compiled; }
+
+  /**
+   * Returns the condition's argument of the given entry as integer.
+   */
+  long GetConditionArgInteger(int _index, int _arg) { return args_integer[args_cond_offset[_index] + _arg]; }
+
+  /**
+   * Returns the condition's argument of the given entry as double.
+   */
+  double GetConditionArgDouble(int _index, int _arg) { return args_double[args_cond_offset[_index] + _arg]; }
+
+  /**
+   * Returns number of the condition's arguments of the given entry.
+   */
+  int GetConditionArgsCount(int _index) { return args_cond_count[_index]; }
+
+  /**
+   * Returns the action's argument of the given entry as integer.
+   */
+  long GetActionArgInteger(int _index, int _arg) { return args_integer[args_action_offset[_index] + _arg]; }
+
+  /**
+   * Returns the action's argument of the given entry as double.
+   */
+  double GetActionArgDouble(int _index, int _arg) { return args_double[args_action_offset[_index] + _arg]; }
+
+  /**
+   * Returns number of the action's arguments of the given entry.
+   */
+  int GetActionArgsCount(int _index) { return args_action_count[_index]; }
+
+  /**
+   * Checks whether functions are bound to both, the condition and the action of the given entry.
+   */
+  bool IsBound(int _index) { return cond_fns[_index] != NULL && action_fns[_index] != NULL; }
+
+  /**
+   * Returns number of entries having the given flag.
+   */
+  unsigned int GetFlagCount(ENUM_TASK_ENTRY_FLAGS _flag) {
+    unsigned int _flags = (unsigned int)_flag;
+    if (_flags != 0 && (_flags & (_flags - 1)) == 0) {
+      // Single flag, using the maintained counter.
+      int _bit = 0;
+      while ((_flags >>= 1) != 0) {
+        _bit++;
+      }
+      return (unsigned int)flag_counts[_bit];
+    }
+    unsigned int _counter = 0;
+    for (int i = 0; i < ArraySize(entries); i++) {
+      if (entries[i].HasFlag((unsigned char)_flag)) {
+        _counter++;
+      }
+    }
+    return _counter;
+  }
+
+  /* Setters */
+
+  /**
+   * Adds entry to the plan.
+   */
+  void Add(TaskEntry &_entry) {
+    int _index = ArraySize(entries);
+    ArrayResize(entries, _index + 1);
+    ArrayResize(args_cond_offset, _index + 1);
+    ArrayResize(args_cond_count, _index + 1);
+    ArrayResize(args_action_offset, _index + 1);
+    ArrayResize(args_action_count, _index + 1);
+    ArrayResize(cond_fns, _index + 1);
+    ArrayResize(action_fns, _index + 1);
+    entries[_index] = _entry;
+    ARRAY(DataParamEntry, _args);
+    TaskConditionEntry _cond = _entry.GetCondition();
+    _cond.ArgsGet(_args);
+    args_cond_offset[_index] = AddArgs(_args);
+    args_cond_count[_index] = ArraySize(_args);
+    TaskActionEntry _action = _entry.GetAction();
+    _action.ArgsGet(_args);
+    args_action_offset[_index] = AddArgs(_args);
+    args_action_count[_index] = ArraySize(_args);
+    CountFlags(_entry.GetFlags(), 1);
+    Bind(_index);
+  }
+
+  /**
+   * Registers function to check conditions of the given id. Binds it to already added entries.
+   */
+  void SetConditionFunction(int _id, TaskPlanFunction _fn) {
+    RegisterFunction(fn_cond_ids, fn_conds, _id, _fn);
+    for (int i = 0; i < ArraySize(entries); i++) {
+      Bind(i);
+    }
+  }
+
+  /**
+   * Registers function to run actions of the given id. Binds it to already added entries.
+   */
+  void SetActionFunction(int _id, TaskPlanFunction _fn) {
+    RegisterFunction(fn_action_ids, fn_actions, _id, _fn);
+    for (int i = 0; i < ArraySize(entries); i++) {
+      Bind(i);
+    }
+  }
+
+  /**
+   * Sets or clears the given flag on all entries.
+   *
+   * @return
+   *   Returns number of changed entries.
+   */
+  unsigned int SetFlags(ENUM_TASK_ENTRY_FLAGS _flag, bool _value = true) {
+    unsigned int _counter = 0;
+    for (int i = 0; i < ArraySize(entries); i++) {
+      if (entries[i].HasFlag((unsigned char)_flag) != _value) {
+        unsigned char _flags = entries[i].GetFlags();
+        entries[i].SetFlag(_flag, _value);
+        Update(i, _flags);
+        _counter++;
+      }
+    }
+    return _counter;
+  }
+
+  /* Main methods */
+
+  /**
+   * Processes the given entry by calling its bound functions.
+   *
+   * @return
+   *   Returns true when entry is active and its condition has been met.
+   */
+  bool Run(int _index) {
+    if (!entries[_index].IsActive()) {
+      return false;
+    }
+    TaskPlanFunction _cond = cond_fns[_index];
+    if (!_cond(THIS_REF, _index)) {
+      return false;
+    }
+    TaskPlanFunction _action = action_fns[_index];
+    _action(THIS_REF, _index);
+    entries[_index].Set(STRUCT_ENUM(TaskEntry, TASK_ENTRY_PROP_LAST_PROCESS), TimeCurrent());
+    if (entries[_index].IsDone()) {
+      entries[_index].SetFlag(TASK_ENTRY_FLAG_IS_DONE,
+                              entries[_index].Get(STRUCT_ENUM(TaskActionEntry, TASK_ACTION_ENTRY_FLAG_IS_DONE)));
+      entries[_index].SetFlag(TASK_ENTRY_FLAG_IS_FAILED,
+                              entries[_index].Get(STRUCT_ENUM(TaskActionEntry, TASK_ACTION_ENTRY_FLAG_IS_FAILED)));
+      entries[_index].SetFlag(TASK_ENTRY_FLAG_IS_INVALID,
+                              entries[_index].Get(STRUCT_ENUM(TaskActionEntry, TASK_ACTION_ENTRY_FLAG_IS_INVALID)));
+      entries[_index].RemoveFlags(TASK_ENTRY_FLAG_IS_ACTIVE);
+    }
+    return true;
+  }
+
+  /**
+   * Updates flag counters after the given entry has been processed.
+   *
+   * @param _flags
+   *   Entry's flags before processing.
+   */
+  void Update(int _index, unsigned char _flags) {
+    unsigned char _new_flags = entries[_index].GetFlags();
+    if (_new_flags != _flags) {
+      CountFlags(_flags, -1);
+      CountFlags(_new_flags, 1);
+    }
+  }
+
+  /**
+   * Removes all entries. Registered functions are kept.
+   */
+  void Clear() {
+    ArrayResize(entries, 0);
+    ArrayResize(args_integer, 0);
+    ArrayResize(args_double, 0);
+    ArrayResize(args_cond_offset, 0);
+    ArrayResize(args_cond_count, 0);
+    ArrayResize(args_action_offset, 0);
+    ArrayResize(args_action_count, 0);
+    ArrayResize(cond_fns, 0);
+    ArrayResize(action_fns, 0);
+    ArrayResize(flag_counts, 8);
+    ArrayInitialize(flag_counts, 0);
+    is_compiled = false;
+  }
+};
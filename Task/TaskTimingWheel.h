@@ -0,0 +1,249 @@
+//+------------------------------------------------------------------+
+//|                                                EA31337 framework |
+//|                                 Copyright 2016-2021, EA31337 Ltd |
+//|                                       https://github.com/EA31337 |
+//+------------------------------------------------------------------+
+
+/*
+ * This file is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file
+ * Implements hierarchical timing wheel used for scheduling tasks.
+ */
+
+#ifndef __MQL__
+// Allows the preprocessor to include a header file when it is needed.
+#pragma once
+#endif
+
+// Prevents processing this includes file for the second time.
+#ifndef TASK_TIMING_WHEEL_H
+#define TASK_TIMING_WHEEL_H
+
+// Includes.
+#include "../Std.h"
+
+#ifndef __MQL__
+#include "../Array.extern.h"
+#endif
+
+// Defines.
+#define TASK_TIMING_WHEEL_BITS 6                                // Number of bits per level.
+#define TASK_TIMING_WHEEL_SLOTS (1 << TASK_TIMING_WHEEL_BITS)  // Number of slots per level.
+#define TASK_TIMING_WHEEL_LEVELS 4                              // Number of levels (~194 days in seconds).
+
+/* Single slot of the timing wheel. */
+struct TaskTimingWheelSlot {
+  ARRAY(int, ids);     // Identifiers of scheduled items.
+  ARRAY(long, times);  // Due times of scheduled items.
+  int size;            // Number of scheduled items.
+  // Constructors.
+  TaskTimingWheelSlot() : size(0) {}
+  // Methods.
+  void Add(int _id, long _time) {
+    if (size >= ArraySize(ids)) {
+      ArrayResize(ids, size + 1, 16);
+      ArrayResize(times, size + 1, 16);
+    }
+    ids[size] = _id;
+    times[size] = _time;
+    ++size;
+  }
+};
+
+/**
+ * Hierarchical timing wheel.
+ *
+ * Keeps identifiers keyed by their due time, so advancing the time costs
+ * O(1) per elapsed time unit plus O(1) per expired item, regardless of the
+ * number of scheduled items. Level 0 has a slot per time unit, each next level
+ * covers TASK_TIMING_WHEEL_SLOTS times longer period. Items of a higher level
+ * are moved into lower levels once their period starts.
+ */
+class TaskTimingWheel {
+ protected:
+  // Slots of all levels followed by the slot of expired items and the slot of items beyond the last level.
+  ARRAY(TaskTimingWheelSlot, slots);
+
+  // Time up to which the wheel has been advanced.
+  long current;
+
+  // Number of scheduled items.
+  int count;
+
+  // Reusable slot for items being moved.
+  TaskTimingWheelSlot moving;
+
+  /**
+   * Returns index of the slot of expired items.
+   */
+  int GetReadySlot() { return TASK_TIMING_WHEEL_LEVELS * TASK_TIMING_WHEEL_SLOTS; }
+
+  /**
+   * Returns index of the slot of items scheduled beyond the last level.
+   */
+  int GetOverflowSlot() { return TASK_TIMING_WHEEL_LEVELS * TASK_TIMING_WHEEL_SLOTS + 1; }
+
+  /**
+   * Places item into the proper slot.
+   */
+  void Place(int _id, long _time) {
+    long _delta = _time - current;
+    if (_delta <= 0) {
+      slots[GetReadySlot()].Add(_id, _time);
+      return;
+    }
+    int _level = 0;
+    long _span = TASK_TIMING_WHEEL_SLOTS;
+    while (_level < TASK_TIMING_WHEEL_LEVELS && _delta >= _span) {
+      ++_level;
+      _span <<= TASK_TIMING_WHEEL_BITS;
+    }
+    if (_level == TASK_TIMING_WHEEL_LEVELS) {
+      slots[GetOverflowSlot()].Add(_id, _time);
+      return;
+    }
+    int _index = (int)((_time >> (TASK_TIMING_WHEEL_BITS * _level)) & (TASK_TIMING_WHEEL_SLOTS - 1));
+    slots[_level * TASK_TIMING_WHEEL_SLOTS + _index].Add(_id, _time);
+  }
+
+  /**
+   * Moves items of the given slot into slots according to the current time.
+   */
+  void Cascade(int _slot) {
+    int _size = slots[_slot].size;
+    if (_size == 0) {
+      return;
+    }
+    // Taking items out first, as they may be placed back into the same slot.
+    int i;
+    moving.size = 0;
+    for (i = 0; i < _size; ++i) {
+      moving.Add(slots[_slot].ids[i], slots[_slot].times[i]);
+    }
+    slots[_slot].size = 0;
+    for (i = 0; i < _size; ++i) {
+      Place(moving.ids[i], moving.times[i]);
+    }
+  }
+
+  /**
+   * Moves all items of the given slot into the output array.
+   */
+  int Drain(int _slot, ARRAY_REF(int, _out), int _num_out) {
+    int _size = slots[_slot].size;
+    if (_num_out + _size > ArraySize(_out)) {
+      ArrayResize(_out, _num_out + _size, 64);
+    }
+    for (int i = 0; i < _size; ++i) {
+      _out[_num_out++] = slots[_slot].ids[i];
+    }
+    slots[_slot].size = 0;
+    count -= _size;
+    return _num_out;
+  }
+
+ public:
+  /**
+   * Constructor.
+   */
+  TaskTimingWheel() : current(0), count(0) { ArrayResize(slots, GetOverflowSlot() + 1); }
+
+  /* Getters */
+
+  /**
+   * Returns number of scheduled items.
+   */
+  int Size() { return count; }
+
+  /**
+   * Returns time up to which the wheel has been advanced.
+   */
+  long GetTime() { return current; }
+
+  /* Main methods */
+
+  /**
+   * Schedules item with the given identifier at the given time.
+   *
+   * Item scheduled at the time which already passed is returned by the next Advance().
+   */
+  void Insert(int _id, long _time) {
+    Place(_id, _time);
+    ++count;
+  }
+
+  /**
+   * Advances the wheel up to the given time.
+   *
+   * @param _out
+   *   Array which receives identifiers of items due at or before the given time.
+   *
+   * @return
+   *   Returns number of items stored in the output array.
+   */
+  int Advance(long _time, ARRAY_REF(int, _out)) {
+    int _num_out = Drain(GetReadySlot(), _out, 0);
+    int i;
+
+    if (count == 0) {
+      current = _time > current ? _time : current;
+      return _num_out;
+    }
+
+    if (_time - current > TASK_TIMING_WHEEL_SLOTS * TASK_TIMING_WHEEL_SLOTS) {
+      // The gap is long (e.g., weekend), so re-placing all items is cheaper than advancing step by step.
+      current = _time;
+      for (i = 0; i < GetReadySlot(); ++i) {
+        Cascade(i);
+      }
+      Cascade(GetOverflowSlot());
+      return Drain(GetReadySlot(), _out, _num_out);
+    }
+
+    while (current < _time) {
+      ++current;
+      // Moving items from higher levels whose period starts now.
+      for (int _level = 1; _level < TASK_TIMING_WHEEL_LEVELS; ++_level) {
+        if ((current & (((long)1 << (TASK_TIMING_WHEEL_BITS * _level)) - 1)) != 0) {
+          break;
+        }
+        Cascade(_level * TASK_TIMING_WHEEL_SLOTS +
+                (int)((current >> (TASK_TIMING_WHEEL_BITS * _level)) & (TASK_TIMING_WHEEL_SLOTS - 1)));
+        if (_level == TASK_TIMING_WHEEL_LEVELS - 1) {
+          Cascade(GetOverflowSlot());
+        }
+      }
+      _num_out = Drain((int)(current & (TASK_TIMING_WHEEL_SLOTS - 1)), _out, _num_out);
+      _num_out = Drain(GetReadySlot(), _out, _num_out);
+    }
+
+    return _num_out;
+  }
+
+  /**
+   * Removes all scheduled items.
+   */
+  void Clear() {
+    for (int i = 0; i < ArraySize(slots); ++i) {
+      slots[i].size = 0;
+    }
+    count = 0;
+  }
+};
+
+#endif  // TASK_TIMING_WHEEL_H
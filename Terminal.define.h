@@ -270,6 +270,11 @@
 #define ERR_INVALID_PARAMETER 4003  // Wrong parameter when calling the system function.
 #endif
 
+#ifndef __MQL__
+// Incorrect value of any type.
+#define WRONG_VALUE -1
+#endif
+
 // MQL defines.
 #ifdef __MQL4__
 #define MQL_VER 4
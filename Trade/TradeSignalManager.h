@@ -32,21 +32,126 @@
 
 /**
  * Class to store and manage a trading signal.
+ *
+ * Active signals are indexed by their timeframe and open direction. Signals
+ * expire in order they were added and processed ones are queued by
+ * SignalSetProcessed(), so refresh touches only the signals to be moved.
+ * Processed and expired signals are kept in rings of TSM_PROP_HISTORY_SIZE size.
  */
 class TradeSignalManager : Dynamic {
  protected:
   DictObject<int, TradeSignal> signals_active;
   DictObject<int, TradeSignal> signals_expired;
   DictObject<int, TradeSignal> signals_processed;
+  ARRAY(TradeSignalManagerGroup, groups);  // Keys of active signals by timeframe and direction.
+  ARRAY(int, expiry_keys);                 // Keys of active signals in order of their expiry.
+  ARRAY(long, expiry_times);               // Expiry times of the signals in expiry_keys.
+  ARRAY(int, pending_keys);                // Keys of signals set as processed or expired since the last refresh.
+  int expiry_head;                         // Position of the next signal to expire.
+  int last_key;                            // Key of the last added signal.
+  unsigned long num_expired;               // Total number of expired signals.
+  unsigned long num_processed;             // Total number of processed signals.
   TradeSignalManagerParams params;
 
   /**
    * Init code (called on constructor).
    */
   void Init() {
-    signals_active.AddFlags(DICT_FLAG_FILL_HOLES_UNSORTED);
-    signals_expired.AddFlags(DICT_FLAG_FILL_HOLES_UNSORTED);
-    signals_processed.AddFlags(DICT_FLAG_FILL_HOLES_UNSORTED);
+    expiry_head = 0;
+    last_key = 0;
+    num_expired = 0;
+    num_processed = 0;
+  }
+
+  /**
+   * Returns group's identifier for a given timeframe and open direction.
+   */
+  long GetGroupId(ENUM_TIMEFRAMES _tf, char _direction) { return (long)_tf * 4 + _direction + 1; }
+
+  /**
+   * Returns index of the group or -1 if not found.
+   */
+  int GetGroupIndex(ENUM_TIMEFRAMES _tf, char _direction, bool _create = false) {
+    long _id = GetGroupId(_tf, _direction);
+    int _size = ArraySize(groups);
+    for (int i = 0; i < _size; i++) {
+      if (groups[i].id == _id) {
+        return i;
+      }
+    }
+    if (!_create) {
+      return -1;
+    }
+    ArrayResize(groups, _size + 1);
+    groups[_size].id = _id;
+    return _size;
+  }
+
+  /**
+   * Moves active signal to the processed or expired ring.
+   */
+  void SignalMove(int _key, TradeSignal &_signal, bool _processed) {
+    int _group = GetGroupIndex(_signal.Get<ENUM_TIMEFRAMES>(STRUCT_ENUM(TradeSignalEntry, TRADE_SIGNAL_PROP_TF)),
+                               _signal.GetSignalOpenDirection());
+    if (_group >= 0) {
+      groups[_group].Remove(_key);
+    }
+    int _history_size = Get<int>(TSM_PROP_HISTORY_SIZE);
+    if (_processed) {
+      signals_processed.Set(_history_size > 0 ? (int)(num_processed % _history_size) : (int)num_processed, _signal);
+      num_processed++;
+    } else {
+      signals_expired.Set(_history_size > 0 ? (int)(num_expired % _history_size) : (int)num_expired, _signal);
+      num_expired++;
+    }
+  }
+
+  /**
+   * Sets flag of the active signal and queues it to be moved on the next refresh.
+   */
+  bool SignalSetFlag(int _key, STRUCT_ENUM(TradeSignalEntry, ENUM_TRADE_SIGNAL_FLAG) _flag) {
+    TradeSignal *_signal = signals_active.GetByKey(_key);
+    if (_signal == NULL) {
+      return false;
+    }
+    _signal PTR_DEREF Set(_flag, true);
+    int _size = ArraySize(pending_keys);
+    ArrayResize(pending_keys, _size + 1, 100);
+    pending_keys[_size] = _key;
+    return true;
+  }
+
+  /**
+   * Expires active signals which expiry time has passed.
+   */
+  void RefreshExpired(long _time) {
+    int _size = ArraySize(expiry_keys);
+    while (expiry_head < _size && expiry_times[expiry_head] <= _time) {
+      int _key = expiry_keys[expiry_head++];
+      TradeSignal *_signal = signals_active.GetByKey(_key);
+      if (_signal == NULL) {
+        // Signal has been already moved.
+        continue;
+      }
+      if (_signal PTR_DEREF Get(STRUCT_ENUM(TradeSignalEntry, TRADE_SIGNAL_FLAG_PROCESSED))) {
+        SignalMove(_key, PTR_TO_REF(_signal), true);
+      } else {
+        _signal PTR_DEREF Set(STRUCT_ENUM(TradeSignalEntry, TRADE_SIGNAL_FLAG_EXPIRED), true);
+        SignalMove(_key, PTR_TO_REF(_signal), false);
+      }
+      signals_active.Unset(_key);
+    }
+    if (expiry_head > 0 && expiry_head * 2 >= _size) {
+      // Dropping already expired entries.
+      int _left = _size - expiry_head;
+      for (int i = 0; i < _left; i++) {
+        expiry_keys[i] = expiry_keys[expiry_head + i];
+        expiry_times[i] = expiry_times[expiry_head + i];
+      }
+      ArrayResize(expiry_keys, _left, 100);
+      ArrayResize(expiry_times, _left, 100);
+      expiry_head = 0;
+    }
   }
 
  public:
@@ -79,24 +184,61 @@ class TradeSignalManager : Dynamic {
     return _iter;
   }
 
+  /**
+   * Gets active signal by its key.
+   *
+   * @return
+   *   Returns NULL if signal is no longer active.
+   */
+  TradeSignal *GetSignalActive(int _key) { return signals_active.GetByKey(_key); }
+
   /**
    * Gets pointer to active signals.
    *
    */
   DictObject<int, TradeSignal> *GetSignalsActive() { return &signals_active; }
 
+  /**
+   * Gets keys of active signals of a given timeframe and open direction.
+   *
+   * @param _direction
+   *   Open direction (1 - buy, -1 - sell, 0 - no open signal).
+   *
+   * @return
+   *   Returns number of keys.
+   */
+  int GetSignalsActive(ENUM_TIMEFRAMES _tf, char _direction, ARRAY_REF(int, _keys)) {
+    int _group = GetGroupIndex(_tf, _direction);
+    int _size = _group >= 0 ? groups[_group].Size() : 0;
+    ArrayResize(_keys, _size);
+    for (int i = 0; i < _size; i++) {
+      _keys[i] = groups[_group].keys[i];
+    }
+    return _size;
+  }
+
   /**
    * Gets pointer to expired signals.
    *
    */
   DictObject<int, TradeSignal> *GetSignalsExpired() { return &signals_expired; }
 
+  /**
+   * Gets total number of expired signals (including ones dropped from the history).
+   */
+  unsigned long GetSignalsExpiredCount() { return num_expired; }
+
   /**
    * Gets pointer to processed signals.
    *
    */
   DictObject<int, TradeSignal> *GetSignalsProcessed() { return &signals_processed; }
 
+  /**
+   * Gets total number of processed signals (including ones dropped from the history).
+   */
+  unsigned long GetSignalsProcessedCount() { return num_processed; }
+
   /* Setters */
 
   /**
@@ -112,29 +254,66 @@ class TradeSignalManager : Dynamic {
   /**
    * Adds new signal.
    *
+   * @return
+   *   Returns key of the added signal.
    */
-  void SignalAdd(TradeSignal &_signal) { signals_active.Push(_signal); }
+  int SignalAdd(TradeSignal &_signal) {
+    int _key = ++last_key;
+    signals_active.Set(_key, _signal);
+    int _group = GetGroupIndex(_signal.Get<ENUM_TIMEFRAMES>(STRUCT_ENUM(TradeSignalEntry, TRADE_SIGNAL_PROP_TF)),
+                               _signal.GetSignalOpenDirection(), true);
+    groups[_group].Add(_key);
+    int _expiry = Get<int>(TSM_PROP_EXPIRY);
+    if (_expiry > 0) {
+      int _size = ArraySize(expiry_keys);
+      ArrayResize(expiry_keys, _size + 1, 100);
+      ArrayResize(expiry_times, _size + 1, 100);
+      expiry_keys[_size] = _key;
+      expiry_times[_size] = ::TimeGMT() + _expiry;
+    }
+    return _key;
+  }
 
   /**
-   * Refresh signals.
+   * Sets active signal as processed, so it is moved on the next refresh.
    *
-   * Move already processed signals or expired to different list.
+   * @return
+   *   Returns false if signal is no longer active.
+   */
+  bool SignalSetProcessed(int _key) {
+    return SignalSetFlag(_key, STRUCT_ENUM(TradeSignalEntry, TRADE_SIGNAL_FLAG_PROCESSED));
+  }
+
+  /**
+   * Sets active signal as expired, so it is moved on the next refresh.
    *
+   * @return
+   *   Returns false if signal is no longer active.
+   */
+  bool SignalSetExpired(int _key) {
+    return SignalSetFlag(_key, STRUCT_ENUM(TradeSignalEntry, TRADE_SIGNAL_FLAG_EXPIRED));
+  }
+
+  /**
+   * Refresh signals.
+   *
+   * Moves signals which expiry time has passed and ones set as processed or expired to different list. Only the
+   * expiry index and the queue of set signals are traversed, active signals are not scanned.
    */
   void Refresh() {
-    for (DictObjectIterator<int, TradeSignal> iter = GetIterSignalsActive(); iter.IsValid(); ++iter) {
-      TradeSignal *_signal = iter.Value();
-      if (_signal PTR_DEREF Get(STRUCT_ENUM(TradeSignalEntry, TRADE_SIGNAL_FLAG_PROCESSED))) {
-        signals_active.Unset(iter);
-        signals_processed.Push(PTR_TO_REF(_signal));
-        continue;
-      }
-      if (_signal PTR_DEREF Get(STRUCT_ENUM(TradeSignalEntry, TRADE_SIGNAL_FLAG_EXPIRED))) {
-        signals_active.Unset(iter);
-        signals_expired.Push(PTR_TO_REF(_signal));
+    RefreshExpired(::TimeGMT());
+    for (int i = 0; i < ArraySize(pending_keys); i++) {
+      int _key = pending_keys[i];
+      TradeSignal *_signal = signals_active.GetByKey(_key);
+      if (_signal == NULL) {
+        // Signal has been already moved.
         continue;
       }
+      SignalMove(_key, PTR_TO_REF(_signal),
+                 _signal PTR_DEREF Get(STRUCT_ENUM(TradeSignalEntry, TRADE_SIGNAL_FLAG_PROCESSED)));
+      signals_active.Unset(_key);
     }
+    ArrayResize(pending_keys, 0, 100);
     Set<long>(TSM_PROP_LAST_CHECK, ::TimeGMT());
   }
 
@@ -28,14 +28,60 @@
 // Defines.
 #define TSM_PROP_FREQ STRUCT_ENUM(TradeSignalManagerParams, TSM_PARAMS_PROP_FREQ)
 #define TSM_PROP_LAST_CHECK STRUCT_ENUM(TradeSignalManagerParams, TSM_PARAMS_PROP_LAST_CHECK)
+#define TSM_PROP_EXPIRY STRUCT_ENUM(TradeSignalManagerParams, TSM_PARAMS_PROP_EXPIRY)
+#define TSM_PROP_HISTORY_SIZE STRUCT_ENUM(TradeSignalManagerParams, TSM_PARAMS_PROP_HISTORY_SIZE)
+
+/**
+ * Keys of active signals sharing the same timeframe and open direction.
+ */
+struct TradeSignalManagerGroup {
+  ARRAY(int, keys);
+  long id;  // Group's identifier (see TradeSignalManager::GetGroupId()).
+
+  /**
+   * Struct constructor.
+   */
+  TradeSignalManagerGroup(long _id = 0) : id(_id) {}
+
+  /**
+   * Adds signal's key to the group.
+   */
+  void Add(int _key) {
+    int _size = ArraySize(keys);
+    ArrayResize(keys, _size + 1, 10);
+    keys[_size] = _key;
+  }
+
+  /**
+   * Removes signal's key from the group (order of keys is not preserved).
+   */
+  bool Remove(int _key) {
+    int _size = ArraySize(keys);
+    for (int i = 0; i < _size; i++) {
+      if (keys[i] == _key) {
+        keys[i] = keys[_size - 1];
+        ArrayResize(keys, _size - 1, 10);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * Returns number of keys in the group.
+   */
+  int Size() { return ArraySize(keys); }
+};
 
 /**
  * Structure to manage TradeSignalManager parameters.
  */
 struct TradeSignalManagerParams {
  protected:
-  short freq;       // Signal process refresh frequency (in sec).
-  long last_check;  // Last check.
+  short freq;        // Signal process refresh frequency (in sec).
+  int expiry;        // Number of seconds after which active signal expires (0 - never).
+  int history_size;  // Number of kept processed and expired signals (0 - unlimited).
+  long last_check;   // Last check.
 
  public:
   /* Struct's enumerations */
@@ -44,12 +90,15 @@ struct TradeSignalManagerParams {
   enum ENUM_TSM_PARAMS_PROP {
     TSM_PARAMS_PROP_FREQ = 0,
     TSM_PARAMS_PROP_LAST_CHECK,
+    TSM_PARAMS_PROP_EXPIRY,
+    TSM_PARAMS_PROP_HISTORY_SIZE,
   };
 
   /**
    * Struct constructor.
    */
-  TradeSignalManagerParams(short _freq = 10) : freq(_freq), last_check(0) {}
+  TradeSignalManagerParams(short _freq = 10, int _history_size = 100, int _expiry = 0)
+      : freq(_freq), expiry(_expiry), history_size(_history_size), last_check(0) {}
 
   /**
    * Struct copy constructor.
@@ -65,6 +114,10 @@ struct TradeSignalManagerParams {
         return (T)freq;
       case TSM_PARAMS_PROP_LAST_CHECK:
         return (T)last_check;
+      case TSM_PARAMS_PROP_EXPIRY:
+        return (T)expiry;
+      case TSM_PARAMS_PROP_HISTORY_SIZE:
+        return (T)history_size;
     }
     SetUserError(ERR_INVALID_PARAMETER);
     return (T)NULL;
@@ -81,6 +134,12 @@ struct TradeSignalManagerParams {
       case TSM_PARAMS_PROP_LAST_CHECK:
         last_check = (long)_value;
         return;
+      case TSM_PARAMS_PROP_EXPIRY:
+        expiry = (int)_value;
+        return;
+      case TSM_PARAMS_PROP_HISTORY_SIZE:
+        history_size = (int)_value;
+        return;
     }
     SetUserError(ERR_INVALID_PARAMETER);
   }
@@ -97,6 +156,8 @@ struct TradeSignalManagerParams {
    */
   SerializerNodeType Serialize(Serializer &_s) {
     _s.Pass(THIS_REF, "freq", freq);
+    _s.Pass(THIS_REF, "expiry", expiry);
+    _s.Pass(THIS_REF, "history_size", history_size);
     return SerializerNodeObject;
   }
 